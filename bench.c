@@ -0,0 +1,342 @@
+// We want clock_gettime()
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#ifdef __linux__
+#include <sys/ptrace.h>
+#endif
+
+#include "termo.h"
+
+// Roughly how much input to decode in each benchmark
+#define BENCH_BYTES (16 << 20)
+// How much input to send through a pipe at once in the burst benchmark
+#define BURST_BYTES (10 << 20)
+
+static double
+now (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Pushes `input' repeatedly into the instance and reads out all the keys
+static void
+run_keys (termo_t *tk, const char *name, const char *input)
+{
+	size_t len = strlen (input);
+	termo_set_buffer_size (tk, len);
+
+	termo_key_t key;
+	unsigned long events = 0, chars = 0;
+	double start = now ();
+	for (size_t total = 0; total < BENCH_BYTES; total += len)
+	{
+		termo_push_bytes (tk, input, len);
+		while (termo_getkey (tk, &key) == TERMO_RES_KEY)
+		{
+			events++;
+			chars += key.type == TERMO_TYPE_TEXT ? key.code.text.count : 1;
+		}
+	}
+
+	double elapsed = now () - start;
+	printf ("%-12s %10.0f chars/s %10.0f events/s %8.2f MB/s\n", name,
+		chars / elapsed, events / elapsed, BENCH_BYTES / elapsed / (1 << 20));
+}
+
+static void
+bench_text (const char *encoding, int flags)
+{
+	termo_t *tk = termo_new_abstract ("vt100", encoding, flags);
+	if (!tk)
+	{
+		fprintf (stderr, "Cannot allocate termo instance for %s\n", encoding);
+		exit (1);
+	}
+
+	run_keys (tk, "ascii", "The quick brown fox jumps over the lazy dog. ");
+	run_keys (tk, "latin", "P\xC5\x99\xC3\xAD\x6C\x69\xC5\xA1 \xC5\xBE"
+		"lu\xC5\xA5ou\xC4\x8Dk\xC3\xBD k\xC5\xAF\xC5\x88 \xC3\xBAp\xC4\x9B"
+		"l \xC4\x8F\xC3\xA1\x62\x65lsk\xC3\xA9 \xC3\xB3\x64y. ");
+	run_keys (tk, "cjk", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xA7"
+		"\xE3\x81\x99\xE3\x80\x82");
+	termo_destroy (tk);
+}
+
+// Decodes a mix of the sequences terminals typically send for special keys
+static void
+bench_seqs (const char *term, int flags)
+{
+	termo_t *tk = termo_new_abstract (term, "UTF-8", flags);
+	if (!tk)
+	{
+		fprintf (stderr, "Cannot allocate termo instance for %s\n", term);
+		exit (1);
+	}
+
+	run_keys (tk, "cursor", "\x1bOA\x1bOB\x1b[C\x1b[D\x1b[H\x1b[F");
+	run_keys (tk, "modified", "\x1b[1;5A\x1b[1;2B\x1b[1;3C\x1b[3;5~");
+	run_keys (tk, "function", "\x1bOP\x1bOQ\x1b[15~\x1b[17~\x1b[24~");
+	run_keys (tk, "control", "\x01\x02\x08\x09\x0d\x7f\x1a\x1f");
+	run_keys (tk, "mouse", "\x1b[<0;12;34M\x1b[<0;12;34m\x1b[<64;1;1M");
+	run_keys (tk, "alt", "\x1b" "f\x1b" "b\x1b" "d\x1b" ".\x1b\x7f\x1b\x01");
+	run_keys (tk, "alt-seqs", "\x1b\x1bOA\x1b\x1b[B\x1b\x1b[1;5C\x1b\x1b[15~");
+	termo_destroy (tk);
+}
+
+// Creates instances for many sessions on the same terminal at once
+static void
+bench_new (const char *term)
+{
+	enum { SESSIONS = 5000 };
+	static termo_t *tks[SESSIONS];
+
+	double start = now ();
+	for (int i = 0; i < SESSIONS; i++)
+		if (!(tks[i] = termo_new_abstract (term, "UTF-8", 0)))
+		{
+			fprintf (stderr, "Cannot allocate termo instance for %s\n", term);
+			exit (1);
+		}
+
+	double elapsed = now () - start;
+	struct rusage usage;
+	getrusage (RUSAGE_SELF, &usage);
+	printf ("%-12s %10.0f instances/s %8ld kB max RSS\n", term,
+		SESSIONS / elapsed, usage.ru_maxrss);
+
+	for (int i = 0; i < SESSIONS; i++)
+		termo_destroy (tks[i]);
+}
+
+// Reads a burst of input from a pipe the way an event loop would,
+// with a buffer that may grow up to `buffer_max', or drains the pipe
+// in each iteration if `budget' is non-zero
+static void
+run_burst (const char *term, const char *name, size_t buffer_max, size_t budget)
+{
+	int fd[2];
+	if (pipe (fd))
+	{
+		perror ("pipe");
+		exit (1);
+	}
+
+	pid_t writer = fork ();
+	if (writer == 0)
+	{
+		static const char pattern[] = "The quick brown fox\x1b[A\x1b[1;5C";
+		char block[4096];
+		for (size_t i = 0; i < sizeof block; i++)
+			block[i] = pattern[i % (sizeof pattern - 1)];
+
+		close (fd[0]);
+		for (size_t total = 0; total < BURST_BYTES; total += sizeof block)
+			write (fd[1], block, sizeof block);
+		_exit (0);
+	}
+	close (fd[1]);
+
+	setenv ("TERM", term, 1);
+	termo_t *tk = termo_new (fd[0], "UTF-8", TERMO_FLAG_NOTERMIOS);
+	if (!tk)
+	{
+		fprintf (stderr, "Cannot allocate termo instance for %s\n", term);
+		exit (1);
+	}
+	termo_set_buffer_max_size (tk, buffer_max);
+
+	termo_key_t key;
+	unsigned long iterations = 0;
+	size_t nbytes;
+	struct pollfd pfd = { .fd = fd[0], .events = POLLIN };
+	double start = now ();
+	while (poll (&pfd, 1, -1) == 1)
+	{
+		iterations++;
+		termo_result_t res = budget
+			? termo_advisereadable_drain (tk, budget, &nbytes)
+			: termo_advisereadable (tk);
+		if (res != TERMO_RES_AGAIN)
+			break;
+		while (termo_getkey (tk, &key) == TERMO_RES_KEY)
+			;
+	}
+
+	double elapsed = now () - start;
+	waitpid (writer, NULL, 0);
+	termo_destroy (tk);
+	close (fd[0]);
+
+	printf ("%-12s %8lu iterations per burst %8.2f MB/s\n", name,
+		iterations, BURST_BYTES / elapsed / (1 << 20));
+}
+
+static void
+bench_burst (const char *term)
+{
+	run_burst (term, "read", 0, 0);
+	run_burst (term, "grow", 1 << 20, 0);
+	run_burst (term, "drain", 1 << 20, 1 << 20);
+}
+
+#ifdef __linux__
+
+// Waits until the reader has taken everything from the terminal's input queue
+static void
+wait_drained (int fd)
+{
+	struct timespec tick = { 0, 100000 };
+	int pending;
+	while (ioctl (fd, FIONREAD, &pending) == 0 && pending > 0)
+		nanosleep (&tick, NULL);
+}
+
+// Roughly how keys arrive when typed: mostly text, whole sequences,
+// sometimes a sequence split in two, and Escape itself.  Keys are written
+// one at a time, so that they don't merge, however slow the reader is.
+static void
+type_keys (int master, int slave, int nkeys)
+{
+	struct timespec gap = { 0, 1000000 }, pause = { 0, 150000000 };
+	for (int i = 0; i < nkeys; i++)
+	{
+		int kind = i % 50;
+		if (kind < 35)
+			write (master, "a", 1);
+		else if (kind < 45)
+			write (master, "\x1b[A", 3);
+		else if (kind < 49)
+		{
+			write (master, "\x1b", 1);
+			wait_drained (slave);
+			nanosleep (&gap, NULL);
+			write (master, "[B", 2);
+		}
+		else
+		{
+			// Escape has to be followed by a pause longer than the waittime
+			write (master, "\x1b", 1);
+			wait_drained (slave);
+			nanosleep (&pause, NULL);
+		}
+		wait_drained (slave);
+		nanosleep (&gap, NULL);
+	}
+}
+
+// Counts the system calls termo_waitkey() makes while reading typed keys
+static void
+run_syscalls (const char *term, const char *name, int flags)
+{
+	enum { KEYS = 1000 };
+
+	int master = posix_openpt (O_RDWR | O_NOCTTY);
+	if (master == -1 || grantpt (master) || unlockpt (master))
+	{
+		perror ("posix_openpt");
+		exit (1);
+	}
+
+	pid_t reader = fork ();
+	if (reader == 0)
+	{
+		int slave = open (ptsname (master), O_RDWR | O_NOCTTY);
+		setenv ("TERM", term, 1);
+		termo_t *tk = termo_new (slave, "UTF-8", flags);
+		if (!tk)
+			_exit (1);
+
+		// Let the parent start counting from here on
+		ptrace (PTRACE_TRACEME, 0, NULL, NULL);
+		raise (SIGSTOP);
+
+		termo_key_t key;
+		int keys = 0;
+		while (keys < KEYS && termo_waitkey (tk, &key) == TERMO_RES_KEY)
+			keys++;
+		_exit (keys != KEYS);
+	}
+
+	int status;
+	waitpid (reader, &status, 0);
+
+	pid_t writer = fork ();
+	if (writer == 0)
+	{
+		type_keys (master, open (ptsname (master), O_RDWR | O_NOCTTY), KEYS);
+		_exit (0);
+	}
+
+	double start = now ();
+	unsigned long stops = 0;
+	while (!ptrace (PTRACE_SYSCALL, reader, NULL, NULL)
+	 && waitpid (reader, &status, 0) == reader && WIFSTOPPED (status))
+		stops++;
+
+	double elapsed = now () - start;
+	waitpid (writer, NULL, 0);
+	close (master);
+
+	if (!WIFEXITED (status) || WEXITSTATUS (status))
+	{
+		fprintf (stderr, "Reading keys has failed\n");
+		exit (1);
+	}
+
+	// Each system call stops the reader on both entry and exit
+	printf ("%-12s %8.0f syscalls per 1000 keys %8.2f s\n", name,
+		stops / 2 * 1000. / KEYS, elapsed);
+}
+
+static void
+bench_syscalls (const char *term)
+{
+	run_syscalls (term, "poll", 0);
+	run_syscalls (term, "vtime", TERMO_FLAG_VTIME);
+}
+
+#endif
+
+int
+main (int argc, char *argv[])
+{
+	TERMO_CHECK_VERSION;
+
+	if (argc == 3 && !strcmp (argv[1], "keys"))
+		bench_text (argv[2], 0);
+	else if (argc == 3 && !strcmp (argv[1], "text"))
+		bench_text (argv[2], TERMO_FLAG_TEXT);
+	else if (argc == 3 && !strcmp (argv[1], "seqs"))
+		bench_seqs (argv[2], 0);
+	else if (argc == 3 && !strcmp (argv[1], "automaton"))
+		bench_seqs (argv[2], TERMO_FLAG_AUTOMATON);
+	else if (argc == 3 && !strcmp (argv[1], "new"))
+		bench_new (argv[2]);
+	else if (argc == 3 && !strcmp (argv[1], "burst"))
+		bench_burst (argv[2]);
+#ifdef __linux__
+	else if (argc == 3 && !strcmp (argv[1], "syscalls"))
+		bench_syscalls (argv[2]);
+#endif
+	else
+	{
+		fprintf (stderr, "Usage: %s { keys | text } ENCODING"
+			" | { seqs | automaton | new | burst | syscalls } TERM\n", argv[0]);
+		return 1;
+	}
+	return 0;
+}
@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 // There are 64 basic codes 0x40 - 0x7F that end a key sequence,
 // plus 0x24 ($) for shifted keys in rxvt-based terminals.
@@ -12,13 +13,38 @@
 // to the terminal.  What the terminal sends back doesn't have to conform to
 // ECMA-48 (and indeed doesn't, as rxvt's 0x24 ($) is out of the range).
 
-static int keyinfo_initialised = 0;
+// The tables are filled in once for the whole process and never change after
+static pthread_once_t keyinfo_once = PTHREAD_ONCE_INIT;
 static struct keyinfo ss3s[96];
 static char ss3_kpalts[96];
 
+// This value must be increased if more CSI arguments are to be accepted
+#define CSI_MAX_ARGS TERMO_CSI_MAX_ARGS
+
+// Allows a CSI sequence arriving in pieces to be parsed incrementally
+typedef struct
+{
+	size_t eaten, start; // Identifies the position of the sequence
+	size_t introlen; // Length of the CSI introducer
+	size_t pos; // Where to continue parsing
+
+	bool allow_dollar; // Whether $ can still end the sequence
+	bool present; // Whether the current parameter has any digits
+	bool in_arg; // Whether the current argument has anything at all
+	bool in_subarg; // Whether the current parameter follows a colon
+	bool args_done; // Whether we've stopped parsing arguments
+	int argi; // Index of the current argument
+	size_t nsubargs; // Number of finished sub-parameters
+	long overflow; // Takes sub-parameters that don't fit
+	unsigned long command; // Initial and intermediate bytes seen so far
+	termo_csi_info_t *info; // Where the rest of the results go
+}
+csi_state_t;
+
 typedef struct
 {
 	termo_t *tk;
+	csi_state_t state;
 }
 termo_csi_t;
 
@@ -38,6 +64,11 @@ handle_csi_ss3_full (termo_t *tk,
 {
 	(void) tk;
 
+	// The command may also have initial and intermediate bytes,
+	// which would take us out of bounds of the table
+	if (cmd > 0xff)
+		return TERMO_RES_NONE;
+
 	if (args > 1 && arg[1] != -1)
 		key->modifiers = arg[1] - 1;
 	else
@@ -179,6 +210,16 @@ handle_csifunc (termo_t *tk, termo_key_t *key, int cmd, long *arg, int args)
 		key->modifiers = 0;
 	key->type = TERMO_TYPE_KEYSYM;
 
+	if ((arg[0] == 200 || arg[0] == 201) && (tk->flags & TERMO_FLAG_PASTE))
+	{
+		// The rest of the paste is handled by termo.c until the end marker,
+		// so 201 only gets here when it comes unpaired.  The paste state
+		// only changes once the key is eaten, this may be just a peek.
+		key->type = arg[0] == 200
+			? TERMO_TYPE_PASTE_BEGIN : TERMO_TYPE_PASTE_END;
+		return TERMO_RES_KEY;
+	}
+
 	if (arg[0] == 27)
 	{
 		int mod = key->modifiers;
@@ -252,9 +293,35 @@ handle_csi_rxvt (termo_t *tk,
 }
 
 //
-// Handler for CSI u extended Unicode keys
+// Handler for CSI u extended Unicode keys, including the kitty keyboard protocol
 //
 
+// The kitty keyboard protocol puts keys without a codepoint of their own
+// into the Private Use Area, starting with Caps Lock
+#define KITTY_KEYS_FIRST 57358
+static struct keyinfo kitty_keys[70];
+#define NKITTYKEYS ((long) (sizeof kitty_keys / sizeof kitty_keys[0]))
+
+// The whole range the protocol reserves for such keys, which also includes
+// media and modifier keys we have no symbols for
+#define KITTY_PUA_FIRST 0xE000
+#define KITTY_PUA_LAST  0xF8FF
+
+// Caps Lock and Num Lock, which we don't report as modifiers
+#define KITTY_KEYMOD_LOCKS (1 << 6 | 1 << 7)
+
+static void
+register_kitty_key (termo_type_t type, termo_sym_t sym, long code)
+{
+	if (code < KITTY_KEYS_FIRST || code >= KITTY_KEYS_FIRST + NKITTYKEYS)
+		return;
+
+	kitty_keys[code - KITTY_KEYS_FIRST].type          = type;
+	kitty_keys[code - KITTY_KEYS_FIRST].sym           = sym;
+	kitty_keys[code - KITTY_KEYS_FIRST].modifier_set  = 0;
+	kitty_keys[code - KITTY_KEYS_FIRST].modifier_mask = 0;
+}
+
 static termo_result_t
 handle_csi_u (termo_t *tk, termo_key_t *key, int cmd, long *arg, int args)
 {
@@ -263,17 +330,43 @@ handle_csi_u (termo_t *tk, termo_key_t *key, int cmd, long *arg, int args)
 	case 'u':
 	{
 		if (args > 1 && arg[1] != -1)
-			key->modifiers = arg[1] - 1;
+			key->modifiers = (arg[1] - 1) & ~KITTY_KEYMOD_LOCKS;
 		else
 			key->modifiers = 0;
 
 		int mod = key->modifiers;
+		long code = arg[0];
+		if (code >= KITTY_KEYS_FIRST && code < KITTY_KEYS_FIRST + NKITTYKEYS)
+		{
+			const struct keyinfo *info = &kitty_keys[code - KITTY_KEYS_FIRST];
+			if (info->sym == TERMO_SYM_UNKNOWN)
+				return TERMO_RES_NONE;
+
+			key->type = info->type;
+			key->code.sym = info->sym;
+			return TERMO_RES_KEY;
+		}
+		// These must never come out as text
+		if (code >= KITTY_PUA_FIRST && code <= KITTY_PUA_LAST)
+			return TERMO_RES_NONE;
+
+		// Prefer the text the key has produced, as with the keyboard layout
+		// applied, which makes Shift redundant, just as in emit_codepoint()
+		if (args > 2 && arg[2] > 0)
+		{
+			code = arg[2];
+			mod &= ~TERMO_KEYMOD_SHIFT;
+		}
+
 		key->type = TERMO_TYPE_KEYSYM;
-		(*tk->method.emit_codepoint) (tk, arg[0], key);
+		(*tk->method.emit_codepoint) (tk, code, key);
 		key->modifiers |= mod;
 		return TERMO_RES_KEY;
 	}
 	default:
+		// Including the reply to our kitty keyboard protocol query,
+		// kept for the user to see as an unknown CSI, and recorded
+		// only once it is eaten, see eat_key()
 		return TERMO_RES_NONE;
 	}
 }
@@ -490,21 +583,67 @@ termo_interpret_modereport (termo_t *tk,
 	return TERMO_RES_KEY;
 }
 
-#define CHARAT(i) (tk->buffer[tk->buffstart + (i)])
+static void
+reset_csi_state (csi_state_t *state, termo_t *tk, size_t introlen)
+{
+	state->eaten = tk->eaten;
+	state->start = tk->buffstart;
+	state->introlen = introlen;
+	state->pos = introlen;
+
+	state->allow_dollar = true;
+	state->present = false;
+	state->in_arg = false;
+	state->in_subarg = false;
+	state->args_done = false;
+	state->argi = 0;
+	state->nsubargs = 0;
+	state->command = 0;
+
+	state->info = &tk->csi_info;
+	state->info->initial = 0;
+	state->info->intermediates[0] = 0;
+	state->info->subargi[0] = 0;
+}
+
+// Terminates the current parameter, whether an argument or a sub-parameter
+static void
+end_csi_param (csi_state_t *state)
+{
+	termo_csi_info_t *info = state->info;
+	if (!state->in_subarg)
+	{
+		if (!state->present)
+			info->args[state->argi] = -1;
+	}
+	else if (state->nsubargs < TERMO_CSI_MAX_SUBARGS)
+	{
+		if (!state->present)
+			info->subargs[state->nsubargs] = -1;
+		state->nsubargs++;
+	}
+	state->present = false;
+}
 
+// Scans the sequence incrementally, continuing where the last call for
+// the same position in the input has stopped.  The results, apart from
+// the length of the sequence, end up in tk->csi_info.
 static termo_result_t
-parse_csi (termo_t *tk, size_t introlen, size_t *csi_len,
-	long args[], size_t *nargs, unsigned long *commandp)
+parse_csi (termo_t *tk, csi_state_t *state, size_t introlen, size_t *csi_len)
 {
-	// Specifically allowing the rxvt special character for shifted function
-	// keys to end a CSI-like sequence, otherwise expecting ECMA-48-like input
-	bool allow_dollar = true;
+	if (state->eaten != tk->eaten || state->start != tk->buffstart
+	 || state->introlen != introlen)
+		reset_csi_state (state, tk, introlen);
 
-	size_t csi_end = introlen;
-	while (csi_end < tk->buffcount)
+	termo_csi_info_t *info = state->info;
+	for (; state->pos < tk->buffcount; state->pos++)
 	{
-		unsigned char c = CHARAT (csi_end);
-		if ((c >= 0x40 && c < 0x80) || (allow_dollar && c == '$'))
+		unsigned char c = CHARAT (state->pos);
+
+		// Specifically allowing the rxvt special character for shifted
+		// function keys to end a CSI-like sequence, otherwise expecting
+		// ECMA-48-like input
+		if ((c >= 0x40 && c < 0x80) || (state->allow_dollar && c == '$'))
 			break;
 
 		// However just accepting the dollar as an end character would break
@@ -512,65 +651,103 @@ parse_csi (termo_t *tk, size_t introlen, size_t *csi_len,
 		// ambiguity by making use of the fact that rxvt key sequences have
 		// exactly one numeric argument and no initial byte.
 		if (c < '0' || c > '9')
-			allow_dollar = false;
-
-		csi_end++;
-	}
-
-	if (csi_end >= tk->buffcount)
-		return TERMO_RES_AGAIN;
-
-	unsigned char cmd = CHARAT (csi_end);
-	*commandp = cmd;
+			state->allow_dollar = false;
 
-	char present = 0;
-	int argi = 0;
-
-	size_t p = introlen;
-
-	// See if there is an initial byte
-	if (CHARAT (p) >= '<' && CHARAT (p) <= '?')
-	{
-		*commandp |= (CHARAT (p) << 8);
-		p++;
-	}
-
-	// Now attempt to parse out up number;number;... separated values
-	for (; p < csi_end; p++)
-	{
-		unsigned char c = CHARAT (p);
-		if (c >= '0' && c <= '9')
+		if (c >= 0x20 && c <= 0x2f)
 		{
-			if (!present)
+			size_t len = strlen (info->intermediates);
+			if (len < TERMO_CSI_MAX_INTERMEDIATES)
 			{
-				args[argi] = c - '0';
-				present = 1;
+				info->intermediates[len] = c;
+				info->intermediates[len + 1] = 0;
 			}
+		}
+
+		if (state->args_done)
+			continue;
+
+		// See if there is an initial byte,
+		// then attempt to parse out up number;number;... separated values,
+		// each of which may be followed by :number:... sub-parameters
+		if (state->pos == introlen && c >= '<' && c <= '?')
+		{
+			state->command |= c << 8;
+			info->initial = c;
+		}
+		else if (c >= '0' && c <= '9')
+		{
+			long *param = &info->args[state->argi];
+			if (state->in_subarg && state->nsubargs < TERMO_CSI_MAX_SUBARGS)
+				param = &info->subargs[state->nsubargs];
+			else if (state->in_subarg)
+				param = &state->overflow;
+
+			if (!state->present)
+				*param = c - '0';
 			else
-				args[argi] = (args[argi] * 10) + c - '0';
+				*param = (*param * 10) + c - '0';
+
+			state->present = true;
+			state->in_arg = true;
+		}
+		else if (c == ':')
+		{
+			end_csi_param (state);
+			state->in_arg = true;
+			state->in_subarg = true;
 		}
 		else if (c == ';')
 		{
-			if (!present)
-				args[argi] = -1;
-			present = 0;
-			argi++;
+			end_csi_param (state);
+			state->in_arg = false;
+			state->in_subarg = false;
 
-			if (argi > 16)
-				break;
+			info->subargi[++state->argi] = state->nsubargs;
+			if (state->argi == CSI_MAX_ARGS)
+				state->args_done = true;
 		}
 		else if (c >= 0x20 && c <= 0x2f)
 		{
-			*commandp |= c << 16;
-			break;
+			state->command |= c << 16;
+			state->args_done = true;
 		}
 	}
 
-	if (present)
-		argi++;
+	if (state->pos >= tk->buffcount)
+		return TERMO_RES_AGAIN;
+
+	// The state stays at the final byte, so that repeated calls are cheap,
+	// and the parameter in progress is only finished within the results
+	info->command = state->command | CHARAT (state->pos);
+	info->final = CHARAT (state->pos);
+	*csi_len = state->pos + 1;
 
-	*nargs = argi;
-	*csi_len = csi_end + 1;
+	info->nargs = state->argi;
+	info->nsubargs = state->nsubargs;
+	if (state->argi < CSI_MAX_ARGS && state->in_arg)
+	{
+		info->nargs++;
+		if (!state->in_subarg && !state->present)
+			info->args[state->argi] = -1;
+		if (state->in_subarg && info->nsubargs < TERMO_CSI_MAX_SUBARGS)
+		{
+			if (!state->present)
+				info->subargs[info->nsubargs] = -1;
+			info->nsubargs++;
+		}
+		info->subargi[info->nargs] = info->nsubargs;
+	}
+	return TERMO_RES_KEY;
+}
+
+termo_result_t
+termo_interpret_csi_info (termo_t *tk, const termo_key_t *key,
+	const termo_csi_info_t **info)
+{
+	if (key->type != TERMO_TYPE_UNKNOWN_CSI || !tk->csi_info_valid)
+		return TERMO_RES_NONE;
+
+	*info = &tk->csi_info;
 	return TERMO_RES_KEY;
 }
 
@@ -578,16 +755,18 @@ termo_result_t
 termo_interpret_csi (termo_t *tk, const termo_key_t *key,
 	long args[], size_t *nargs, unsigned long *cmd)
 {
-	if (tk->hightide == 0)
-		return TERMO_RES_NONE;
-	if (key->type != TERMO_TYPE_UNKNOWN_CSI)
+	const termo_csi_info_t *info;
+	if (termo_interpret_csi_info (tk, key, &info) != TERMO_RES_KEY)
 		return TERMO_RES_NONE;
 
-	size_t dummy;
-	return parse_csi (tk, 0, &dummy, args, nargs, cmd);
+	if (info->nargs < *nargs)
+		*nargs = info->nargs;
+	memcpy (args, info->args, *nargs * sizeof *args);
+	*cmd = info->command;
+	return TERMO_RES_KEY;
 }
 
-static int
+static void
 register_keys (void)
 {
 	int i;
@@ -599,6 +778,8 @@ register_keys (void)
 	}
 	for (i = 0; i < NCSIFUNCS; i++)
 		csifuncs[i].sym = TERMO_SYM_UNKNOWN;
+	for (i = 0; i < NKITTYKEYS; i++)
+		kitty_keys[i].sym = TERMO_SYM_UNKNOWN;
 
 	// Cursor keys handling; there's some weird, weird stuff going on here:
 	//
@@ -693,6 +874,32 @@ register_keys (void)
 	register_csifunc (TERMO_TYPE_FUNCTION, 19, 33);
 	register_csifunc (TERMO_TYPE_FUNCTION, 20, 34);
 
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_PRINT, 57361);
+	for (i = 13; i <= 35; i++)
+		register_kitty_key (TERMO_TYPE_FUNCTION, i, 57376 + i - 13);
+	for (i = 0; i <= 9; i++)
+		register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_KP0 + i, 57399 + i);
+
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_KPPERIOD, 57409);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_KPDIV,    57410);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_KPMULT,   57411);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_KPMINUS,  57412);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_KPPLUS,   57413);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_KPENTER,  57414);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_KPEQUALS, 57415);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_KPCOMMA,  57416);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_LEFT,     57417);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_RIGHT,    57418);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_UP,       57419);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_DOWN,     57420);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_PAGEUP,   57421);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_PAGEDOWN, 57422);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_HOME,     57423);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_END,      57424);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_INSERT,   57425);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_DELETE,   57426);
+	register_kitty_key (TERMO_TYPE_KEYSYM, TERMO_SYM_BEGIN,    57427);
+
 	csi_handlers['u' - 0x20] = &handle_csi_u;
 
 	csi_handlers['M' - 0x20] = &handle_csi_m;
@@ -708,9 +915,6 @@ register_keys (void)
 	csi_handlers['^' - 0x20] = &handle_csi_rxvt;
 	csi_handlers['$' - 0x20] = &handle_csi_rxvt;
 	csi_handlers['@' - 0x20] = &handle_csi_rxvt;
-
-	keyinfo_initialised = 1;
-	return 1;
 }
 
 static void *
@@ -718,7 +922,7 @@ new_driver (termo_t *tk, const char *term)
 {
 	(void) term;
 
-	if (!keyinfo_initialised && !register_keys ())
+	if (pthread_once (&keyinfo_once, register_keys))
 		return NULL;
 
 	termo_csi_t *csi = malloc (sizeof *csi);
@@ -726,6 +930,7 @@ new_driver (termo_t *tk, const char *term)
 		return NULL;
 
 	csi->tk = tk;
+	reset_csi_state (&csi->state, tk, 0);
 	return csi;
 }
 
@@ -740,14 +945,8 @@ static termo_result_t
 peekkey_csi (termo_t *tk, termo_csi_t *csi,
 	size_t introlen, termo_key_t *key, int flags, size_t *nbytep)
 {
-	(void) csi;
-
 	size_t csi_len;
-	size_t args = 16;
-	long arg[16];
-	unsigned long cmd;
-
-	termo_result_t ret = parse_csi (tk, introlen, &csi_len, arg, &args, &cmd);
+	termo_result_t ret = parse_csi (tk, &csi->state, introlen, &csi_len);
 	if (ret == TERMO_RES_AGAIN)
 	{
 		if (!(flags & PEEKKEY_FORCE))
@@ -759,17 +958,20 @@ peekkey_csi (termo_t *tk, termo_csi_t *csi,
 		return TERMO_RES_KEY;
 	}
 
+	termo_csi_info_t *info = csi->state.info;
+	unsigned long cmd = info->command;
+	long *arg = info->args;
+	size_t args = info->nargs;
+
 	// Mouse in X10 encoding consumes the next 3 bytes also (or more with 1005)
 	if (cmd == 'M' && args < 3)
 	{
-		tk->buffstart += csi_len;
-		tk->buffcount -= csi_len;
+		hide_bytes (tk, csi_len);
 
 		termo_result_t mouse_result =
 			(*tk->method.peekkey_mouse) (tk, key, nbytep);
 
-		tk->buffstart -= csi_len;
-		tk->buffcount += csi_len;
+		unhide_bytes (tk, csi_len);
 
 		if (mouse_result == TERMO_RES_KEY)
 			*nbytep += csi_len;
@@ -805,14 +1007,29 @@ peekkey_csi (termo_t *tk, termo_csi_t *csi,
 			break;
 		}
 #endif
+		// The arguments have been kept for termo_interpret_csi_info()
 		key->type = TERMO_TYPE_UNKNOWN_CSI;
 		key->code.number = cmd;
 
-		tk->hightide = csi_len - introlen;
-		*nbytep = introlen; // Do not yet eat the data bytes
+		tk->csi_info_valid = true;
+		*nbytep = csi_len;
 		return TERMO_RES_KEY;
 	}
 
+	// The kitty keyboard protocol may follow modifiers with the event type,
+	// as in CSI 1;1:3A, in all key sequences
+	if (result == TERMO_RES_KEY && args > 1
+	 && info->subargi[1] < info->subargi[2]
+	 && (key->type == TERMO_TYPE_KEY || key->type == TERMO_TYPE_KEYSYM
+	  || key->type == TERMO_TYPE_FUNCTION))
+	{
+		long event = info->subargs[info->subargi[1]];
+		if (event == 2)
+			key->event = TERMO_KEY_REPEAT;
+		if (event == 3)
+			key->event = TERMO_KEY_RELEASE;
+	}
+
 	*nbytep = csi_len;
 	return result;
 }
@@ -900,10 +1117,118 @@ peekkey (termo_t *tk, void *info,
 	return TERMO_RES_NONE;
 }
 
+static bool
+starts_sequence (void *info, unsigned char byte)
+{
+	(void) info;
+	return byte == 0x1b || byte == 0x8f || byte == 0x9b;
+}
+
+static void
+add_key (termo_t *tk, automaton_builder_t *b,
+	const unsigned char *seq, size_t len, const termo_key_t *key)
+{
+	keyinfo_t info =
+	{
+		.type = key->type,
+		.sym = key->code.sym,
+		.modifier_set = key->modifiers,
+	};
+	(*tk->method.add_sequence) (b, seq, len, AUTOMATON_KEY, &info);
+}
+
+// Only keys that don't depend on arguments or flags can be described,
+// that is, plain CSI/SS3 cmd keys and CSI number ~ function keys
+static void
+add_csi_sequences (termo_t *tk, automaton_builder_t *b,
+	const char *intro, size_t introlen)
+{
+	unsigned char seq[8];
+	memcpy (seq, intro, introlen);
+
+	termo_key_t key;
+	long arg[1];
+	for (int cmd = 0x40; cmd < 0x80; cmd++)
+	{
+		csi_handler_fn handler = csi_handlers[cmd - 0x20];
+		if (handler != &handle_csi_ss3_full
+		 && handler != &handle_csi_cursor
+		 && handler != &handle_csi_cursor_rxvt)
+			continue;
+		if ((*handler) (tk, &key, cmd, arg, 0) != TERMO_RES_KEY)
+			continue;
+
+		seq[introlen] = cmd;
+		add_key (tk, b, seq, introlen + 1, &key);
+	}
+
+	// Also covering rxvt's modified variants
+	static const char finals[] = "~^$@";
+	for (arg[0] = 0; arg[0] < NCSIFUNCS; arg[0]++)
+	{
+		// 27 stands for a character given in another argument
+		if (arg[0] == 27 || csifuncs[arg[0]].sym == TERMO_SYM_UNKNOWN)
+			continue;
+
+		size_t len = introlen
+			+ sprintf ((char *) seq + introlen, "%ld", arg[0]) + 1;
+		for (const char *f = finals; *f; f++)
+		{
+			csi_handler_fn handler = csi_handlers[*f - 0x20];
+			if (!handler || (*handler) (tk, &key, *f, arg, 1) != TERMO_RES_KEY)
+				continue;
+
+			seq[len - 1] = *f;
+			add_key (tk, b, seq, len, &key);
+		}
+	}
+}
+
+static void
+add_ss3_sequences (termo_t *tk, automaton_builder_t *b,
+	const char *intro, size_t introlen)
+{
+	unsigned char seq[3];
+	memcpy (seq, intro, introlen);
+
+	// Mirroring peekkey_ss3(), except for keypad keys subject to flags
+	for (int cmd = 0x40; cmd < 0x80; cmd++)
+	{
+		const struct keyinfo *info = &ss3s[cmd - 0x20];
+		if (info->sym == TERMO_SYM_UNKNOWN)
+			info = &csi_ss3s[cmd - 0x20];
+		else if (ss3_kpalts[cmd - 0x20])
+			continue;
+		if (info->sym == TERMO_SYM_UNKNOWN)
+			continue;
+
+		keyinfo_t key = *info;
+		key.modifier_mask = 0;
+
+		seq[introlen] = cmd;
+		(*tk->method.add_sequence) (b, seq, introlen + 1, AUTOMATON_KEY, &key);
+	}
+}
+
+static bool
+add_sequences (termo_t *tk, void *info, automaton_builder_t *b)
+{
+	(void) info;
+
+	// C1 introducers are rare enough not to be worth the memory
+	add_csi_sequences (tk, b, "\x1b[", 2);
+	add_ss3_sequences (tk, b, "\x1bO", 2);
+
+	// Sequences with arguments have to go through peekkey()
+	return false;
+}
+
 termo_driver_t termo_driver_csi =
 {
-	.name        = "CSI",
-	.new_driver  = new_driver,
-	.free_driver = free_driver,
-	.peekkey     = peekkey,
+	.name            = "CSI",
+	.new_driver      = new_driver,
+	.free_driver     = free_driver,
+	.peekkey         = peekkey,
+	.starts_sequence = starts_sequence,
+	.add_sequences   = add_sequences,
 };
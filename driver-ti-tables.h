@@ -0,0 +1,1282 @@
+// Generated by termo-gen-tables, do not edit
+
+typedef char builtin_ti_check[TERMO_N_SYMS == 60
+	&& TERMO_TYPE_FUNCTION == 1 && TERMO_TYPE_KEYSYM == 2 ? 1 : -1];
+
+// xterm-256color
+
+static const keyinfo_t builtin_keys_xterm_256color[] =
+{
+	{ 2, 1, 0, 0 },
+	{ 2, 7, 0, 0 },
+	{ 2, 8, 0, 0 },
+	{ 2, 10, 0, 0 },
+	{ 2, 9, 0, 0 },
+	{ 2, 11, 0, 0 },
+	{ 2, 19, 0, 0 },
+	{ 2, 18, 0, 0 },
+	{ 2, 3, 0, 0 },
+	{ 1, 1, 0, 0 },
+	{ 1, 2, 0, 0 },
+	{ 1, 3, 0, 0 },
+	{ 1, 4, 0, 0 },
+	{ 2, 2, 1, 1 },
+	{ 2, 13, 0, 0 },
+	{ 2, 14, 0, 0 },
+	{ 2, 16, 0, 0 },
+	{ 2, 17, 0, 0 },
+	{ 1, 5, 0, 0 },
+	{ 1, 6, 0, 0 },
+	{ 1, 7, 0, 0 },
+	{ 1, 8, 0, 0 },
+	{ 1, 9, 0, 0 },
+	{ 1, 10, 0, 0 },
+	{ 1, 11, 0, 0 },
+	{ 1, 12, 0, 0 },
+	{ 2, 10, 1, 1 },
+	{ 2, 9, 1, 1 },
+	{ 2, 19, 1, 1 },
+	{ 2, 18, 1, 1 },
+	{ 1, 13, 0, 0 },
+	{ 1, 14, 0, 0 },
+	{ 1, 15, 0, 0 },
+	{ 1, 16, 0, 0 },
+	{ 1, 49, 0, 0 },
+	{ 1, 50, 0, 0 },
+	{ 1, 51, 0, 0 },
+	{ 1, 52, 0, 0 },
+	{ 1, 61, 0, 0 },
+	{ 1, 62, 0, 0 },
+	{ 1, 63, 0, 0 },
+	{ 1, 25, 0, 0 },
+	{ 1, 26, 0, 0 },
+	{ 1, 27, 0, 0 },
+	{ 1, 28, 0, 0 },
+	{ 1, 37, 0, 0 },
+	{ 1, 38, 0, 0 },
+	{ 1, 39, 0, 0 },
+	{ 1, 40, 0, 0 },
+	{ 2, 13, 1, 1 },
+	{ 2, 14, 1, 1 },
+	{ 2, 16, 1, 1 },
+	{ 2, 17, 1, 1 },
+	{ 1, 17, 0, 0 },
+	{ 1, 53, 0, 0 },
+	{ 1, 29, 0, 0 },
+	{ 1, 41, 0, 0 },
+	{ 1, 18, 0, 0 },
+	{ 1, 54, 0, 0 },
+	{ 1, 30, 0, 0 },
+	{ 1, 42, 0, 0 },
+	{ 1, 19, 0, 0 },
+	{ 1, 55, 0, 0 },
+	{ 1, 31, 0, 0 },
+	{ 1, 43, 0, 0 },
+	{ 1, 20, 0, 0 },
+	{ 1, 56, 0, 0 },
+	{ 1, 32, 0, 0 },
+	{ 1, 44, 0, 0 },
+	{ 1, 21, 0, 0 },
+	{ 1, 57, 0, 0 },
+	{ 1, 33, 0, 0 },
+	{ 1, 45, 0, 0 },
+	{ 1, 22, 0, 0 },
+	{ 1, 58, 0, 0 },
+	{ 1, 34, 0, 0 },
+	{ 1, 46, 0, 0 },
+	{ 1, 23, 0, 0 },
+	{ 1, 59, 0, 0 },
+	{ 1, 35, 0, 0 },
+	{ 1, 47, 0, 0 },
+	{ 1, 24, 0, 0 },
+	{ 1, 60, 0, 0 },
+	{ 1, 36, 0, 0 },
+	{ 1, 48, 0, 0 },
+};
+
+static const trie_node_t builtin_nodes_xterm_256color[] =
+{
+	{ 1, 0x1b, 0x7f, 0 },
+	{ 1, 0x4f, 0x5b, 101 },
+	{ 0, 0x00, 0x00, 0 },
+	{ 1, 0x41, 0x53, 114 },
+	{ 1, 0x31, 0x5a, 133 },
+	{ 0, 0x00, 0x00, 1 },
+	{ 0, 0x00, 0x00, 2 },
+	{ 0, 0x00, 0x00, 3 },
+	{ 0, 0x00, 0x00, 4 },
+	{ 0, 0x00, 0x00, 5 },
+	{ 0, 0x00, 0x00, 6 },
+	{ 0, 0x00, 0x00, 7 },
+	{ 0, 0x00, 0x00, 8 },
+	{ 0, 0x00, 0x00, 9 },
+	{ 0, 0x00, 0x00, 10 },
+	{ 0, 0x00, 0x00, 11 },
+	{ 0, 0x00, 0x00, 12 },
+	{ 1, 0x35, 0x3b, 175 },
+	{ 1, 0x30, 0x7e, 182 },
+	{ 1, 0x3b, 0x7e, 261 },
+	{ 1, 0x3b, 0x7e, 329 },
+	{ 1, 0x3b, 0x7e, 397 },
+	{ 2, 0x00, 0x00, 13 },
+	{ 0, 0x00, 0x00, 13 },
+	{ 1, 0x3b, 0x7e, 465 },
+	{ 1, 0x3b, 0x7e, 533 },
+	{ 1, 0x3b, 0x7e, 601 },
+	{ 1, 0x3b, 0x7e, 669 },
+	{ 1, 0x32, 0x36, 737 },
+	{ 1, 0x3b, 0x7e, 742 },
+	{ 1, 0x3b, 0x7e, 810 },
+	{ 1, 0x3b, 0x7e, 878 },
+	{ 1, 0x3b, 0x7e, 946 },
+	{ 1, 0x32, 0x32, 1014 },
+	{ 0, 0x00, 0x00, 14 },
+	{ 1, 0x32, 0x32, 1015 },
+	{ 0, 0x00, 0x00, 15 },
+	{ 1, 0x32, 0x32, 1016 },
+	{ 0, 0x00, 0x00, 16 },
+	{ 1, 0x32, 0x32, 1017 },
+	{ 0, 0x00, 0x00, 17 },
+	{ 1, 0x32, 0x36, 1018 },
+	{ 0, 0x00, 0x00, 18 },
+	{ 1, 0x32, 0x36, 1023 },
+	{ 0, 0x00, 0x00, 19 },
+	{ 1, 0x32, 0x36, 1028 },
+	{ 0, 0x00, 0x00, 20 },
+	{ 1, 0x32, 0x36, 1033 },
+	{ 0, 0x00, 0x00, 21 },
+	{ 1, 0x43, 0x53, 1038 },
+	{ 1, 0x50, 0x53, 1055 },
+	{ 1, 0x50, 0x52, 1059 },
+	{ 1, 0x50, 0x53, 1062 },
+	{ 1, 0x50, 0x53, 1066 },
+	{ 1, 0x32, 0x36, 1070 },
+	{ 0, 0x00, 0x00, 22 },
+	{ 1, 0x32, 0x36, 1075 },
+	{ 0, 0x00, 0x00, 23 },
+	{ 1, 0x32, 0x36, 1080 },
+	{ 0, 0x00, 0x00, 24 },
+	{ 1, 0x32, 0x36, 1085 },
+	{ 0, 0x00, 0x00, 25 },
+	{ 1, 0x7e, 0x7e, 1090 },
+	{ 1, 0x7e, 0x7e, 1091 },
+	{ 1, 0x7e, 0x7e, 1092 },
+	{ 1, 0x7e, 0x7e, 1093 },
+	{ 1, 0x7e, 0x7e, 1094 },
+	{ 1, 0x7e, 0x7e, 1095 },
+	{ 1, 0x7e, 0x7e, 1096 },
+	{ 1, 0x7e, 0x7e, 1097 },
+	{ 1, 0x7e, 0x7e, 1098 },
+	{ 1, 0x7e, 0x7e, 1099 },
+	{ 1, 0x7e, 0x7e, 1100 },
+	{ 1, 0x7e, 0x7e, 1101 },
+	{ 1, 0x7e, 0x7e, 1102 },
+	{ 1, 0x7e, 0x7e, 1103 },
+	{ 1, 0x7e, 0x7e, 1104 },
+	{ 1, 0x7e, 0x7e, 1105 },
+	{ 1, 0x7e, 0x7e, 1106 },
+	{ 1, 0x7e, 0x7e, 1107 },
+	{ 1, 0x7e, 0x7e, 1108 },
+	{ 1, 0x7e, 0x7e, 1109 },
+	{ 0, 0x00, 0x00, 26 },
+	{ 0, 0x00, 0x00, 27 },
+	{ 0, 0x00, 0x00, 28 },
+	{ 0, 0x00, 0x00, 29 },
+	{ 0, 0x00, 0x00, 30 },
+	{ 0, 0x00, 0x00, 31 },
+	{ 0, 0x00, 0x00, 32 },
+	{ 0, 0x00, 0x00, 33 },
+	{ 0, 0x00, 0x00, 34 },
+	{ 0, 0x00, 0x00, 35 },
+	{ 0, 0x00, 0x00, 36 },
+	{ 0, 0x00, 0x00, 37 },
+	{ 0, 0x00, 0x00, 38 },
+	{ 0, 0x00, 0x00, 39 },
+	{ 0, 0x00, 0x00, 40 },
+	{ 0, 0x00, 0x00, 41 },
+	{ 0, 0x00, 0x00, 42 },
+	{ 0, 0x00, 0x00, 43 },
+	{ 0, 0x00, 0x00, 44 },
+	{ 0, 0x00, 0x00, 45 },
+	{ 0, 0x00, 0x00, 46 },
+	{ 0, 0x00, 0x00, 47 },
+	{ 0, 0x00, 0x00, 48 },
+	{ 1, 0x7e, 0x7e, 1110 },
+	{ 1, 0x7e, 0x7e, 1111 },
+	{ 1, 0x7e, 0x7e, 1112 },
+	{ 1, 0x7e, 0x7e, 1113 },
+	{ 1, 0x7e, 0x7e, 1114 },
+	{ 1, 0x7e, 0x7e, 1115 },
+	{ 1, 0x7e, 0x7e, 1116 },
+	{ 1, 0x7e, 0x7e, 1117 },
+	{ 1, 0x7e, 0x7e, 1118 },
+	{ 1, 0x7e, 0x7e, 1119 },
+	{ 1, 0x7e, 0x7e, 1120 },
+	{ 1, 0x7e, 0x7e, 1121 },
+	{ 1, 0x7e, 0x7e, 1122 },
+	{ 1, 0x7e, 0x7e, 1123 },
+	{ 1, 0x7e, 0x7e, 1124 },
+	{ 1, 0x7e, 0x7e, 1125 },
+	{ 0, 0x00, 0x00, 49 },
+	{ 0, 0x00, 0x00, 50 },
+	{ 0, 0x00, 0x00, 51 },
+	{ 0, 0x00, 0x00, 52 },
+	{ 0, 0x00, 0x00, 53 },
+	{ 0, 0x00, 0x00, 54 },
+	{ 0, 0x00, 0x00, 55 },
+	{ 0, 0x00, 0x00, 56 },
+	{ 0, 0x00, 0x00, 57 },
+	{ 0, 0x00, 0x00, 58 },
+	{ 0, 0x00, 0x00, 59 },
+	{ 0, 0x00, 0x00, 60 },
+	{ 0, 0x00, 0x00, 61 },
+	{ 0, 0x00, 0x00, 62 },
+	{ 0, 0x00, 0x00, 63 },
+	{ 0, 0x00, 0x00, 64 },
+	{ 0, 0x00, 0x00, 65 },
+	{ 0, 0x00, 0x00, 66 },
+	{ 0, 0x00, 0x00, 67 },
+	{ 0, 0x00, 0x00, 68 },
+	{ 0, 0x00, 0x00, 69 },
+	{ 0, 0x00, 0x00, 70 },
+	{ 0, 0x00, 0x00, 71 },
+	{ 0, 0x00, 0x00, 72 },
+	{ 0, 0x00, 0x00, 73 },
+	{ 0, 0x00, 0x00, 74 },
+	{ 0, 0x00, 0x00, 75 },
+	{ 0, 0x00, 0x00, 76 },
+	{ 0, 0x00, 0x00, 77 },
+	{ 0, 0x00, 0x00, 78 },
+	{ 0, 0x00, 0x00, 79 },
+	{ 0, 0x00, 0x00, 80 },
+	{ 0, 0x00, 0x00, 81 },
+	{ 0, 0x00, 0x00, 82 },
+	{ 0, 0x00, 0x00, 83 },
+	{ 0, 0x00, 0x00, 84 },
+};
+
+static const uint16_t builtin_children_xterm_256color[] =
+{
+	1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 2, 3, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 4, 5, 6, 7, 8, 9, 10,
+	0, 11, 0, 0, 0, 0, 12, 0, 0, 13, 14, 15,
+	16, 17, 18, 19, 0, 20, 21, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 22, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 23, 24, 0, 25, 26, 27,
+	0, 28, 29, 30, 0, 31, 32, 0, 0, 0, 0, 0,
+	0, 33, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 34, 35, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 36, 37, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	38, 39, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 40, 41, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 42, 43, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	44, 45, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 46, 47, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 48, 49, 50, 51, 52, 53, 54, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 55, 56, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 57, 58, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 59, 60, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 61, 62, 63, 64, 65, 66, 67,
+	0, 68, 69, 70, 71, 0, 72, 73, 74, 75, 0, 76,
+	77, 78, 79, 0, 80, 81, 82, 83, 0, 84, 0, 85,
+	0, 0, 0, 0, 0, 0, 0, 86, 87, 88, 89, 90,
+	91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102,
+	103, 104, 105, 106, 0, 107, 108, 109, 110, 0, 111, 112,
+	113, 114, 0, 115, 116, 117, 118, 0, 119, 120, 121, 122,
+	123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134,
+	135, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 146,
+	147, 148, 149, 150, 151, 152, 153, 154, 155, 156,
+};
+
+// screen-256color
+
+static const keyinfo_t builtin_keys_screen_256color[] =
+{
+	{ 2, 1, 0, 0 },
+	{ 2, 7, 0, 0 },
+	{ 2, 8, 0, 0 },
+	{ 2, 10, 0, 0 },
+	{ 2, 9, 0, 0 },
+	{ 1, 1, 0, 0 },
+	{ 1, 2, 0, 0 },
+	{ 1, 3, 0, 0 },
+	{ 1, 4, 0, 0 },
+	{ 2, 2, 1, 1 },
+	{ 2, 18, 0, 0 },
+	{ 2, 13, 0, 0 },
+	{ 2, 14, 0, 0 },
+	{ 2, 19, 0, 0 },
+	{ 2, 16, 0, 0 },
+	{ 2, 17, 0, 0 },
+	{ 1, 5, 0, 0 },
+	{ 1, 6, 0, 0 },
+	{ 1, 7, 0, 0 },
+	{ 1, 8, 0, 0 },
+	{ 1, 9, 0, 0 },
+	{ 1, 10, 0, 0 },
+	{ 1, 11, 0, 0 },
+	{ 1, 12, 0, 0 },
+};
+
+static const trie_node_t builtin_nodes_screen_256color[] =
+{
+	{ 1, 0x1b, 0x7f, 0 },
+	{ 1, 0x4f, 0x5b, 101 },
+	{ 0, 0x00, 0x00, 0 },
+	{ 1, 0x41, 0x53, 114 },
+	{ 1, 0x31, 0x5a, 133 },
+	{ 0, 0x00, 0x00, 1 },
+	{ 0, 0x00, 0x00, 2 },
+	{ 0, 0x00, 0x00, 3 },
+	{ 0, 0x00, 0x00, 4 },
+	{ 0, 0x00, 0x00, 5 },
+	{ 0, 0x00, 0x00, 6 },
+	{ 0, 0x00, 0x00, 7 },
+	{ 0, 0x00, 0x00, 8 },
+	{ 1, 0x35, 0x7e, 175 },
+	{ 1, 0x30, 0x7e, 249 },
+	{ 1, 0x7e, 0x7e, 328 },
+	{ 1, 0x7e, 0x7e, 329 },
+	{ 1, 0x7e, 0x7e, 330 },
+	{ 1, 0x7e, 0x7e, 331 },
+	{ 2, 0x00, 0x00, 9 },
+	{ 0, 0x00, 0x00, 9 },
+	{ 1, 0x7e, 0x7e, 332 },
+	{ 1, 0x7e, 0x7e, 333 },
+	{ 1, 0x7e, 0x7e, 334 },
+	{ 1, 0x7e, 0x7e, 335 },
+	{ 0, 0x00, 0x00, 10 },
+	{ 1, 0x7e, 0x7e, 336 },
+	{ 1, 0x7e, 0x7e, 337 },
+	{ 1, 0x7e, 0x7e, 338 },
+	{ 1, 0x7e, 0x7e, 339 },
+	{ 0, 0x00, 0x00, 11 },
+	{ 0, 0x00, 0x00, 12 },
+	{ 0, 0x00, 0x00, 13 },
+	{ 0, 0x00, 0x00, 14 },
+	{ 0, 0x00, 0x00, 15 },
+	{ 0, 0x00, 0x00, 16 },
+	{ 0, 0x00, 0x00, 17 },
+	{ 0, 0x00, 0x00, 18 },
+	{ 0, 0x00, 0x00, 19 },
+	{ 0, 0x00, 0x00, 20 },
+	{ 0, 0x00, 0x00, 21 },
+	{ 0, 0x00, 0x00, 22 },
+	{ 0, 0x00, 0x00, 23 },
+};
+
+static const uint16_t builtin_children_screen_256color[] =
+{
+	1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 2, 3, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 4, 5, 6, 7, 8, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 10, 11,
+	12, 13, 14, 15, 16, 17, 18, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 19, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 20, 21, 0, 22, 23, 24,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 25, 26, 27, 0,
+	28, 29, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 30, 31, 32, 33, 34, 35, 36, 37, 38,
+	39, 40, 41, 42,
+};
+
+// tmux-256color
+
+static const keyinfo_t builtin_keys_tmux_256color[] =
+{
+	{ 2, 1, 0, 0 },
+	{ 2, 7, 0, 0 },
+	{ 2, 8, 0, 0 },
+	{ 2, 10, 0, 0 },
+	{ 2, 9, 0, 0 },
+	{ 1, 1, 0, 0 },
+	{ 1, 2, 0, 0 },
+	{ 1, 3, 0, 0 },
+	{ 1, 4, 0, 0 },
+	{ 2, 2, 1, 1 },
+	{ 2, 18, 0, 0 },
+	{ 2, 13, 0, 0 },
+	{ 2, 14, 0, 0 },
+	{ 2, 19, 0, 0 },
+	{ 2, 16, 0, 0 },
+	{ 2, 17, 0, 0 },
+	{ 1, 5, 0, 0 },
+	{ 1, 6, 0, 0 },
+	{ 1, 7, 0, 0 },
+	{ 1, 8, 0, 0 },
+	{ 1, 9, 0, 0 },
+	{ 1, 10, 0, 0 },
+	{ 1, 11, 0, 0 },
+	{ 1, 12, 0, 0 },
+	{ 2, 10, 1, 1 },
+	{ 2, 9, 1, 1 },
+	{ 2, 19, 1, 1 },
+	{ 2, 18, 1, 1 },
+	{ 1, 13, 0, 0 },
+	{ 1, 14, 0, 0 },
+	{ 1, 15, 0, 0 },
+	{ 1, 16, 0, 0 },
+	{ 1, 49, 0, 0 },
+	{ 1, 50, 0, 0 },
+	{ 1, 51, 0, 0 },
+	{ 1, 52, 0, 0 },
+	{ 1, 61, 0, 0 },
+	{ 1, 62, 0, 0 },
+	{ 1, 63, 0, 0 },
+	{ 1, 25, 0, 0 },
+	{ 1, 26, 0, 0 },
+	{ 1, 27, 0, 0 },
+	{ 1, 28, 0, 0 },
+	{ 1, 37, 0, 0 },
+	{ 1, 38, 0, 0 },
+	{ 1, 39, 0, 0 },
+	{ 1, 40, 0, 0 },
+	{ 2, 13, 1, 1 },
+	{ 2, 14, 1, 1 },
+	{ 2, 16, 1, 1 },
+	{ 2, 17, 1, 1 },
+	{ 1, 17, 0, 0 },
+	{ 1, 53, 0, 0 },
+	{ 1, 29, 0, 0 },
+	{ 1, 41, 0, 0 },
+	{ 1, 18, 0, 0 },
+	{ 1, 54, 0, 0 },
+	{ 1, 30, 0, 0 },
+	{ 1, 42, 0, 0 },
+	{ 1, 19, 0, 0 },
+	{ 1, 55, 0, 0 },
+	{ 1, 31, 0, 0 },
+	{ 1, 43, 0, 0 },
+	{ 1, 20, 0, 0 },
+	{ 1, 56, 0, 0 },
+	{ 1, 32, 0, 0 },
+	{ 1, 44, 0, 0 },
+	{ 1, 21, 0, 0 },
+	{ 1, 57, 0, 0 },
+	{ 1, 33, 0, 0 },
+	{ 1, 45, 0, 0 },
+	{ 1, 22, 0, 0 },
+	{ 1, 58, 0, 0 },
+	{ 1, 34, 0, 0 },
+	{ 1, 46, 0, 0 },
+	{ 1, 23, 0, 0 },
+	{ 1, 59, 0, 0 },
+	{ 1, 35, 0, 0 },
+	{ 1, 47, 0, 0 },
+	{ 1, 24, 0, 0 },
+	{ 1, 60, 0, 0 },
+	{ 1, 36, 0, 0 },
+	{ 1, 48, 0, 0 },
+};
+
+static const trie_node_t builtin_nodes_tmux_256color[] =
+{
+	{ 1, 0x1b, 0x7f, 0 },
+	{ 1, 0x4f, 0x5b, 101 },
+	{ 0, 0x00, 0x00, 0 },
+	{ 1, 0x41, 0x53, 114 },
+	{ 1, 0x31, 0x5a, 133 },
+	{ 0, 0x00, 0x00, 1 },
+	{ 0, 0x00, 0x00, 2 },
+	{ 0, 0x00, 0x00, 3 },
+	{ 0, 0x00, 0x00, 4 },
+	{ 0, 0x00, 0x00, 5 },
+	{ 0, 0x00, 0x00, 6 },
+	{ 0, 0x00, 0x00, 7 },
+	{ 0, 0x00, 0x00, 8 },
+	{ 1, 0x35, 0x7e, 175 },
+	{ 1, 0x30, 0x7e, 249 },
+	{ 1, 0x3b, 0x7e, 328 },
+	{ 1, 0x7e, 0x7e, 396 },
+	{ 1, 0x3b, 0x7e, 397 },
+	{ 1, 0x3b, 0x7e, 465 },
+	{ 2, 0x00, 0x00, 9 },
+	{ 0, 0x00, 0x00, 9 },
+	{ 1, 0x3b, 0x7e, 533 },
+	{ 1, 0x3b, 0x7e, 601 },
+	{ 1, 0x3b, 0x7e, 669 },
+	{ 1, 0x3b, 0x7e, 737 },
+	{ 1, 0x32, 0x36, 805 },
+	{ 0, 0x00, 0x00, 10 },
+	{ 1, 0x3b, 0x7e, 810 },
+	{ 1, 0x3b, 0x7e, 878 },
+	{ 1, 0x3b, 0x7e, 946 },
+	{ 1, 0x3b, 0x7e, 1014 },
+	{ 1, 0x32, 0x32, 1082 },
+	{ 0, 0x00, 0x00, 11 },
+	{ 1, 0x32, 0x32, 1083 },
+	{ 0, 0x00, 0x00, 12 },
+	{ 0, 0x00, 0x00, 13 },
+	{ 1, 0x32, 0x32, 1084 },
+	{ 0, 0x00, 0x00, 14 },
+	{ 1, 0x32, 0x32, 1085 },
+	{ 0, 0x00, 0x00, 15 },
+	{ 1, 0x32, 0x36, 1086 },
+	{ 0, 0x00, 0x00, 16 },
+	{ 1, 0x32, 0x36, 1091 },
+	{ 0, 0x00, 0x00, 17 },
+	{ 1, 0x32, 0x36, 1096 },
+	{ 0, 0x00, 0x00, 18 },
+	{ 1, 0x32, 0x36, 1101 },
+	{ 0, 0x00, 0x00, 19 },
+	{ 1, 0x43, 0x53, 1106 },
+	{ 1, 0x50, 0x53, 1123 },
+	{ 1, 0x50, 0x52, 1127 },
+	{ 1, 0x50, 0x53, 1130 },
+	{ 1, 0x50, 0x53, 1134 },
+	{ 1, 0x32, 0x36, 1138 },
+	{ 0, 0x00, 0x00, 20 },
+	{ 1, 0x32, 0x36, 1143 },
+	{ 0, 0x00, 0x00, 21 },
+	{ 1, 0x32, 0x36, 1148 },
+	{ 0, 0x00, 0x00, 22 },
+	{ 1, 0x32, 0x36, 1153 },
+	{ 0, 0x00, 0x00, 23 },
+	{ 1, 0x7e, 0x7e, 1158 },
+	{ 1, 0x7e, 0x7e, 1159 },
+	{ 1, 0x7e, 0x7e, 1160 },
+	{ 1, 0x7e, 0x7e, 1161 },
+	{ 1, 0x7e, 0x7e, 1162 },
+	{ 1, 0x7e, 0x7e, 1163 },
+	{ 1, 0x7e, 0x7e, 1164 },
+	{ 1, 0x7e, 0x7e, 1165 },
+	{ 1, 0x7e, 0x7e, 1166 },
+	{ 1, 0x7e, 0x7e, 1167 },
+	{ 1, 0x7e, 0x7e, 1168 },
+	{ 1, 0x7e, 0x7e, 1169 },
+	{ 1, 0x7e, 0x7e, 1170 },
+	{ 1, 0x7e, 0x7e, 1171 },
+	{ 1, 0x7e, 0x7e, 1172 },
+	{ 1, 0x7e, 0x7e, 1173 },
+	{ 1, 0x7e, 0x7e, 1174 },
+	{ 1, 0x7e, 0x7e, 1175 },
+	{ 1, 0x7e, 0x7e, 1176 },
+	{ 1, 0x7e, 0x7e, 1177 },
+	{ 0, 0x00, 0x00, 24 },
+	{ 0, 0x00, 0x00, 25 },
+	{ 0, 0x00, 0x00, 26 },
+	{ 0, 0x00, 0x00, 27 },
+	{ 0, 0x00, 0x00, 28 },
+	{ 0, 0x00, 0x00, 29 },
+	{ 0, 0x00, 0x00, 30 },
+	{ 0, 0x00, 0x00, 31 },
+	{ 0, 0x00, 0x00, 32 },
+	{ 0, 0x00, 0x00, 33 },
+	{ 0, 0x00, 0x00, 34 },
+	{ 0, 0x00, 0x00, 35 },
+	{ 0, 0x00, 0x00, 36 },
+	{ 0, 0x00, 0x00, 37 },
+	{ 0, 0x00, 0x00, 38 },
+	{ 0, 0x00, 0x00, 39 },
+	{ 0, 0x00, 0x00, 40 },
+	{ 0, 0x00, 0x00, 41 },
+	{ 0, 0x00, 0x00, 42 },
+	{ 0, 0x00, 0x00, 43 },
+	{ 0, 0x00, 0x00, 44 },
+	{ 0, 0x00, 0x00, 45 },
+	{ 0, 0x00, 0x00, 46 },
+	{ 1, 0x7e, 0x7e, 1178 },
+	{ 1, 0x7e, 0x7e, 1179 },
+	{ 1, 0x7e, 0x7e, 1180 },
+	{ 1, 0x7e, 0x7e, 1181 },
+	{ 1, 0x7e, 0x7e, 1182 },
+	{ 1, 0x7e, 0x7e, 1183 },
+	{ 1, 0x7e, 0x7e, 1184 },
+	{ 1, 0x7e, 0x7e, 1185 },
+	{ 1, 0x7e, 0x7e, 1186 },
+	{ 1, 0x7e, 0x7e, 1187 },
+	{ 1, 0x7e, 0x7e, 1188 },
+	{ 1, 0x7e, 0x7e, 1189 },
+	{ 1, 0x7e, 0x7e, 1190 },
+	{ 1, 0x7e, 0x7e, 1191 },
+	{ 1, 0x7e, 0x7e, 1192 },
+	{ 1, 0x7e, 0x7e, 1193 },
+	{ 0, 0x00, 0x00, 47 },
+	{ 0, 0x00, 0x00, 48 },
+	{ 0, 0x00, 0x00, 49 },
+	{ 0, 0x00, 0x00, 50 },
+	{ 0, 0x00, 0x00, 51 },
+	{ 0, 0x00, 0x00, 52 },
+	{ 0, 0x00, 0x00, 53 },
+	{ 0, 0x00, 0x00, 54 },
+	{ 0, 0x00, 0x00, 55 },
+	{ 0, 0x00, 0x00, 56 },
+	{ 0, 0x00, 0x00, 57 },
+	{ 0, 0x00, 0x00, 58 },
+	{ 0, 0x00, 0x00, 59 },
+	{ 0, 0x00, 0x00, 60 },
+	{ 0, 0x00, 0x00, 61 },
+	{ 0, 0x00, 0x00, 62 },
+	{ 0, 0x00, 0x00, 63 },
+	{ 0, 0x00, 0x00, 64 },
+	{ 0, 0x00, 0x00, 65 },
+	{ 0, 0x00, 0x00, 66 },
+	{ 0, 0x00, 0x00, 67 },
+	{ 0, 0x00, 0x00, 68 },
+	{ 0, 0x00, 0x00, 69 },
+	{ 0, 0x00, 0x00, 70 },
+	{ 0, 0x00, 0x00, 71 },
+	{ 0, 0x00, 0x00, 72 },
+	{ 0, 0x00, 0x00, 73 },
+	{ 0, 0x00, 0x00, 74 },
+	{ 0, 0x00, 0x00, 75 },
+	{ 0, 0x00, 0x00, 76 },
+	{ 0, 0x00, 0x00, 77 },
+	{ 0, 0x00, 0x00, 78 },
+	{ 0, 0x00, 0x00, 79 },
+	{ 0, 0x00, 0x00, 80 },
+	{ 0, 0x00, 0x00, 81 },
+	{ 0, 0x00, 0x00, 82 },
+};
+
+static const uint16_t builtin_children_tmux_256color[] =
+{
+	1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 2, 3, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 4, 5, 6, 7, 8, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 10, 11,
+	12, 13, 14, 15, 16, 17, 18, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 19, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 20, 21, 0, 22, 23, 24,
+	0, 25, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 26, 27, 28, 0,
+	29, 30, 0, 0, 0, 0, 0, 0, 31, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 32, 33, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 34,
+	35, 36, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 37, 38, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 39, 40, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	41, 42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 43, 44, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 45, 46, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	47, 48, 49, 50, 51, 52, 53, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 54, 55, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 56, 57, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 58, 59, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 60, 61, 62, 63, 64, 65, 66, 0, 67, 68, 69,
+	70, 0, 71, 72, 73, 74, 0, 75, 76, 77, 78, 0,
+	79, 80, 81, 82, 0, 83, 0, 84, 0, 0, 0, 0,
+	0, 0, 0, 85, 86, 87, 88, 89, 90, 91, 92, 93,
+	94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105,
+	0, 106, 107, 108, 109, 0, 110, 111, 112, 113, 0, 114,
+	115, 116, 117, 0, 118, 119, 120, 121, 122, 123, 124, 125,
+	126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137,
+	138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149,
+	150, 151, 152, 153, 154, 155,
+};
+
+// rxvt-unicode-256color
+
+static const keyinfo_t builtin_keys_rxvt_unicode_256color[] =
+{
+	{ 2, 1, 0, 0 },
+	{ 2, 3, 0, 0 },
+	{ 2, 7, 0, 0 },
+	{ 2, 8, 0, 0 },
+	{ 2, 10, 0, 0 },
+	{ 2, 9, 0, 0 },
+	{ 2, 2, 1, 1 },
+	{ 2, 10, 1, 1 },
+	{ 2, 9, 1, 1 },
+	{ 2, 12, 1, 1 },
+	{ 2, 12, 0, 0 },
+	{ 2, 13, 1, 1 },
+	{ 2, 13, 0, 0 },
+	{ 2, 14, 1, 1 },
+	{ 2, 14, 0, 0 },
+	{ 2, 15, 0, 0 },
+	{ 2, 16, 1, 1 },
+	{ 2, 16, 0, 0 },
+	{ 2, 17, 1, 1 },
+	{ 2, 17, 0, 0 },
+	{ 2, 18, 1, 1 },
+	{ 2, 18, 0, 0 },
+	{ 2, 19, 1, 1 },
+	{ 2, 19, 0, 0 },
+	{ 1, 1, 0, 0 },
+	{ 1, 2, 0, 0 },
+	{ 1, 3, 0, 0 },
+	{ 1, 4, 0, 0 },
+	{ 1, 5, 0, 0 },
+	{ 1, 6, 0, 0 },
+	{ 1, 7, 0, 0 },
+	{ 1, 8, 0, 0 },
+	{ 1, 9, 0, 0 },
+	{ 1, 10, 0, 0 },
+	{ 1, 11, 0, 0 },
+	{ 1, 12, 0, 0 },
+	{ 1, 13, 0, 0 },
+	{ 1, 14, 0, 0 },
+	{ 1, 15, 0, 0 },
+	{ 1, 16, 0, 0 },
+	{ 1, 17, 0, 0 },
+	{ 1, 18, 0, 0 },
+	{ 1, 19, 0, 0 },
+	{ 1, 20, 0, 0 },
+};
+
+static const trie_node_t builtin_nodes_rxvt_unicode_256color[] =
+{
+	{ 1, 0x1b, 0x7f, 0 },
+	{ 1, 0x4f, 0x5b, 101 },
+	{ 0, 0x00, 0x00, 0 },
+	{ 1, 0x4d, 0x4d, 114 },
+	{ 1, 0x31, 0x64, 115 },
+	{ 0, 0x00, 0x00, 1 },
+	{ 1, 0x24, 0x7e, 167 },
+	{ 1, 0x24, 0x7e, 258 },
+	{ 1, 0x24, 0x7e, 349 },
+	{ 1, 0x7e, 0x7e, 440 },
+	{ 1, 0x24, 0x7e, 441 },
+	{ 1, 0x24, 0x7e, 532 },
+	{ 1, 0x24, 0x7e, 623 },
+	{ 1, 0x24, 0x7e, 714 },
+	{ 0, 0x00, 0x00, 2 },
+	{ 0, 0x00, 0x00, 3 },
+	{ 0, 0x00, 0x00, 4 },
+	{ 0, 0x00, 0x00, 5 },
+	{ 2, 0x00, 0x00, 6 },
+	{ 0, 0x00, 0x00, 6 },
+	{ 0, 0x00, 0x00, 7 },
+	{ 0, 0x00, 0x00, 8 },
+	{ 0, 0x00, 0x00, 9 },
+	{ 1, 0x7e, 0x7e, 805 },
+	{ 1, 0x7e, 0x7e, 806 },
+	{ 1, 0x7e, 0x7e, 807 },
+	{ 1, 0x7e, 0x7e, 808 },
+	{ 1, 0x7e, 0x7e, 809 },
+	{ 1, 0x7e, 0x7e, 810 },
+	{ 1, 0x7e, 0x7e, 811 },
+	{ 1, 0x7e, 0x7e, 812 },
+	{ 0, 0x00, 0x00, 10 },
+	{ 0, 0x00, 0x00, 11 },
+	{ 1, 0x7e, 0x7e, 813 },
+	{ 1, 0x7e, 0x7e, 814 },
+	{ 1, 0x7e, 0x7e, 815 },
+	{ 1, 0x7e, 0x7e, 816 },
+	{ 1, 0x7e, 0x7e, 817 },
+	{ 1, 0x7e, 0x7e, 818 },
+	{ 1, 0x7e, 0x7e, 819 },
+	{ 1, 0x7e, 0x7e, 820 },
+	{ 0, 0x00, 0x00, 12 },
+	{ 0, 0x00, 0x00, 13 },
+	{ 1, 0x7e, 0x7e, 821 },
+	{ 1, 0x7e, 0x7e, 822 },
+	{ 1, 0x7e, 0x7e, 823 },
+	{ 1, 0x7e, 0x7e, 824 },
+	{ 0, 0x00, 0x00, 14 },
+	{ 0, 0x00, 0x00, 15 },
+	{ 0, 0x00, 0x00, 16 },
+	{ 0, 0x00, 0x00, 17 },
+	{ 0, 0x00, 0x00, 18 },
+	{ 0, 0x00, 0x00, 19 },
+	{ 0, 0x00, 0x00, 20 },
+	{ 0, 0x00, 0x00, 21 },
+	{ 0, 0x00, 0x00, 22 },
+	{ 0, 0x00, 0x00, 23 },
+	{ 0, 0x00, 0x00, 24 },
+	{ 0, 0x00, 0x00, 25 },
+	{ 0, 0x00, 0x00, 26 },
+	{ 0, 0x00, 0x00, 27 },
+	{ 0, 0x00, 0x00, 28 },
+	{ 0, 0x00, 0x00, 29 },
+	{ 0, 0x00, 0x00, 30 },
+	{ 0, 0x00, 0x00, 31 },
+	{ 0, 0x00, 0x00, 32 },
+	{ 0, 0x00, 0x00, 33 },
+	{ 0, 0x00, 0x00, 34 },
+	{ 0, 0x00, 0x00, 35 },
+	{ 0, 0x00, 0x00, 36 },
+	{ 0, 0x00, 0x00, 37 },
+	{ 0, 0x00, 0x00, 38 },
+	{ 0, 0x00, 0x00, 39 },
+	{ 0, 0x00, 0x00, 40 },
+	{ 0, 0x00, 0x00, 41 },
+	{ 0, 0x00, 0x00, 42 },
+	{ 0, 0x00, 0x00, 43 },
+};
+
+static const uint16_t builtin_children_rxvt_unicode_256color[] =
+{
+	1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 2, 3, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 4, 5, 6, 7, 8, 9, 10,
+	11, 12, 13, 0, 0, 0, 0, 0, 0, 0, 0, 14,
+	15, 16, 17, 0, 0, 0, 0, 0, 0, 0, 0, 18,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	19, 0, 0, 0, 0, 0, 0, 0, 0, 20, 21, 22,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	23, 24, 25, 26, 27, 0, 28, 29, 30, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 31, 32, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 33, 34, 0, 35, 36, 37,
+	38, 0, 39, 40, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	41, 42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 43, 44, 45, 46, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 47, 48, 49, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 50, 51, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 52, 53,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 54, 55, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67,
+	68, 69, 70, 71, 72, 73, 74, 75, 76,
+};
+
+// linux
+
+static const keyinfo_t builtin_keys_linux[] =
+{
+	{ 2, 40, 0, 0 },
+	{ 2, 1, 0, 0 },
+	{ 2, 2, 1, 1 },
+	{ 2, 7, 0, 0 },
+	{ 2, 8, 0, 0 },
+	{ 2, 10, 0, 0 },
+	{ 2, 9, 0, 0 },
+	{ 2, 18, 0, 0 },
+	{ 2, 13, 0, 0 },
+	{ 2, 14, 0, 0 },
+	{ 2, 19, 0, 0 },
+	{ 2, 16, 0, 0 },
+	{ 2, 17, 0, 0 },
+	{ 1, 1, 0, 0 },
+	{ 1, 2, 0, 0 },
+	{ 1, 3, 0, 0 },
+	{ 1, 4, 0, 0 },
+	{ 1, 5, 0, 0 },
+	{ 1, 6, 0, 0 },
+	{ 1, 7, 0, 0 },
+	{ 1, 8, 0, 0 },
+	{ 1, 9, 0, 0 },
+	{ 1, 10, 0, 0 },
+	{ 1, 11, 0, 0 },
+	{ 1, 12, 0, 0 },
+	{ 1, 13, 0, 0 },
+	{ 1, 14, 0, 0 },
+	{ 1, 15, 0, 0 },
+	{ 1, 16, 0, 0 },
+	{ 1, 17, 0, 0 },
+	{ 1, 18, 0, 0 },
+	{ 1, 19, 0, 0 },
+	{ 1, 20, 0, 0 },
+};
+
+static const trie_node_t builtin_nodes_linux[] =
+{
+	{ 1, 0x1a, 0x7f, 0 },
+	{ 0, 0x00, 0x00, 0 },
+	{ 1, 0x09, 0x5b, 102 },
+	{ 0, 0x00, 0x00, 1 },
+	{ 0, 0x00, 0x00, 2 },
+	{ 1, 0x31, 0x5b, 185 },
+	{ 1, 0x37, 0x7e, 228 },
+	{ 1, 0x30, 0x7e, 300 },
+	{ 1, 0x31, 0x7e, 379 },
+	{ 1, 0x7e, 0x7e, 457 },
+	{ 1, 0x7e, 0x7e, 458 },
+	{ 1, 0x7e, 0x7e, 459 },
+	{ 0, 0x00, 0x00, 3 },
+	{ 0, 0x00, 0x00, 4 },
+	{ 0, 0x00, 0x00, 5 },
+	{ 0, 0x00, 0x00, 6 },
+	{ 2, 0x00, 0x00, 7 },
+	{ 1, 0x41, 0x45, 460 },
+	{ 1, 0x7e, 0x7e, 465 },
+	{ 1, 0x7e, 0x7e, 466 },
+	{ 1, 0x7e, 0x7e, 467 },
+	{ 0, 0x00, 0x00, 7 },
+	{ 1, 0x7e, 0x7e, 468 },
+	{ 1, 0x7e, 0x7e, 469 },
+	{ 1, 0x7e, 0x7e, 470 },
+	{ 1, 0x7e, 0x7e, 471 },
+	{ 1, 0x7e, 0x7e, 472 },
+	{ 1, 0x7e, 0x7e, 473 },
+	{ 1, 0x7e, 0x7e, 474 },
+	{ 1, 0x7e, 0x7e, 475 },
+	{ 0, 0x00, 0x00, 8 },
+	{ 1, 0x7e, 0x7e, 476 },
+	{ 1, 0x7e, 0x7e, 477 },
+	{ 1, 0x7e, 0x7e, 478 },
+	{ 1, 0x7e, 0x7e, 479 },
+	{ 0, 0x00, 0x00, 9 },
+	{ 0, 0x00, 0x00, 10 },
+	{ 0, 0x00, 0x00, 11 },
+	{ 0, 0x00, 0x00, 12 },
+	{ 0, 0x00, 0x00, 13 },
+	{ 0, 0x00, 0x00, 14 },
+	{ 0, 0x00, 0x00, 15 },
+	{ 0, 0x00, 0x00, 16 },
+	{ 0, 0x00, 0x00, 17 },
+	{ 0, 0x00, 0x00, 18 },
+	{ 0, 0x00, 0x00, 19 },
+	{ 0, 0x00, 0x00, 20 },
+	{ 0, 0x00, 0x00, 21 },
+	{ 0, 0x00, 0x00, 22 },
+	{ 0, 0x00, 0x00, 23 },
+	{ 0, 0x00, 0x00, 24 },
+	{ 0, 0x00, 0x00, 25 },
+	{ 0, 0x00, 0x00, 26 },
+	{ 0, 0x00, 0x00, 27 },
+	{ 0, 0x00, 0x00, 28 },
+	{ 0, 0x00, 0x00, 29 },
+	{ 0, 0x00, 0x00, 30 },
+	{ 0, 0x00, 0x00, 31 },
+	{ 0, 0x00, 0x00, 32 },
+};
+
+static const uint16_t builtin_children_linux[] =
+{
+	1, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 3, 4, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 5, 6, 7, 8, 9, 10, 11, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 13, 14,
+	15, 0, 0, 0, 0, 0, 0, 0, 0, 16, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 17,
+	18, 19, 20, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 21,
+	22, 23, 0, 24, 25, 26, 27, 0, 28, 29, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 30, 31, 32, 33, 34, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46,
+	47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58,
+};
+
+// vt100
+
+static const keyinfo_t builtin_keys_vt100[] =
+{
+	{ 2, 1, 0, 0 },
+	{ 2, 7, 0, 0 },
+	{ 2, 8, 0, 0 },
+	{ 2, 10, 0, 0 },
+	{ 2, 9, 0, 0 },
+	{ 2, 3, 0, 0 },
+	{ 1, 1, 0, 0 },
+	{ 1, 2, 0, 0 },
+	{ 1, 3, 0, 0 },
+	{ 1, 4, 0, 0 },
+	{ 1, 8, 0, 0 },
+	{ 1, 5, 0, 0 },
+	{ 1, 6, 0, 0 },
+	{ 1, 7, 0, 0 },
+	{ 1, 9, 0, 0 },
+	{ 1, 10, 0, 0 },
+};
+
+static const trie_node_t builtin_nodes_vt100[] =
+{
+	{ 1, 0x08, 0x1b, 0 },
+	{ 0, 0x00, 0x00, 0 },
+	{ 1, 0x4f, 0x4f, 20 },
+	{ 1, 0x41, 0x78, 21 },
+	{ 0, 0x00, 0x00, 1 },
+	{ 0, 0x00, 0x00, 2 },
+	{ 0, 0x00, 0x00, 3 },
+	{ 0, 0x00, 0x00, 4 },
+	{ 0, 0x00, 0x00, 5 },
+	{ 0, 0x00, 0x00, 6 },
+	{ 0, 0x00, 0x00, 7 },
+	{ 0, 0x00, 0x00, 8 },
+	{ 0, 0x00, 0x00, 9 },
+	{ 0, 0x00, 0x00, 10 },
+	{ 0, 0x00, 0x00, 11 },
+	{ 0, 0x00, 0x00, 12 },
+	{ 0, 0x00, 0x00, 13 },
+	{ 0, 0x00, 0x00, 14 },
+	{ 0, 0x00, 0x00, 15 },
+};
+
+static const uint16_t builtin_children_vt100[] =
+{
+	1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 2, 3, 4, 5, 6,
+	7, 0, 0, 0, 0, 0, 0, 0, 0, 8, 0, 0,
+	9, 10, 11, 12, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 13, 0, 0, 0, 0, 0, 0, 0,
+	14, 15, 16, 17, 18,
+};
+
+static const builtin_ti_t builtin_ti[] =
+{
+	{
+		"xterm-256color", true,
+		builtin_keys_xterm_256color, 85,
+		builtin_nodes_xterm_256color, 157,
+		builtin_children_xterm_256color, 1126,
+		"\033[?1h\033=",
+		"\033[?1l\033>",
+		"\033[?1006;1000%?%p1%{1}%=%th%el%;",
+	},
+	{
+		"screen-256color", true,
+		builtin_keys_screen_256color, 24,
+		builtin_nodes_screen_256color, 43,
+		builtin_children_screen_256color, 340,
+		"\033[?1h\033=",
+		"\033[?1l\033>",
+		"\033[?1000%?%p1%{1}%=%th%el%;",
+	},
+	{
+		"tmux-256color", true,
+		builtin_keys_tmux_256color, 83,
+		builtin_nodes_tmux_256color, 156,
+		builtin_children_tmux_256color, 1194,
+		"\033[?1h\033=",
+		"\033[?1l\033>",
+		"\033[?1000%?%p1%{1}%=%th%el%;",
+	},
+	{
+		"rxvt-unicode-256color", true,
+		builtin_keys_rxvt_unicode_256color, 44,
+		builtin_nodes_rxvt_unicode_256color, 77,
+		builtin_children_rxvt_unicode_256color, 825,
+		"\033=",
+		"\033>",
+		"\033[?1000%?%p1%{1}%=%th%el%;",
+	},
+	{
+		"linux", true,
+		builtin_keys_linux, 33,
+		builtin_nodes_linux, 59,
+		builtin_children_linux, 480,
+		NULL,
+		NULL,
+		"\033[?1000%?%p1%{1}%=%th%el%;",
+	},
+	{
+		"vt100", false,
+		builtin_keys_vt100, 16,
+		builtin_nodes_vt100, 19,
+		builtin_children_vt100, 77,
+		"\033[?1h\033=",
+		"\033[?1l\033>",
+		"\033[?1000%?%p1%{1}%=%th%el%;",
+	},
+	{ NULL },
+};
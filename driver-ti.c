@@ -4,9 +4,9 @@
 #include "termo.h"
 #include "termo-internal.h"
 
-#ifdef HAVE_UNIBILIUM
+#if defined HAVE_UNIBILIUM
 # include <unibilium.h>
-#else
+#elif defined HAVE_CURSES
 # include <curses.h>
 # include <term.h>
 #endif
@@ -15,11 +15,19 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // To be efficient at lookups, we store the byte sequence => keyinfo mapping
 // in a trie. This avoids a slow linear search through a flat list of
-// sequences. Because it is likely most nodes will be very sparse, we optimise
-// vector to store an extent map after the database is loaded.
+// sequences. Because it is likely most nodes will be very sparse, each node
+// only has child slots for the extent of bytes that it actually uses.
+//
+// The trie is compiled breadth-first into a single allocation, with children
+// referred to by 16-bit indices, so that lookups stay within a few cache lines.
+// Index 0 is the root, which isn't anyone's child, so it also means "none".
 
 typedef enum
 {
@@ -29,154 +37,597 @@ typedef enum
 }
 trie_nodetype_t;
 
-typedef struct trie_node
+typedef struct
 {
-	trie_nodetype_t type;
+	uint8_t type;           // trie_nodetype_t
+	unsigned char min, max; // INCLUSIVE endpoints of the extent range
+	uint16_t index;         // Into children for arrays, into keys for keys
 }
 trie_node_t;
 
-typedef struct trie_node_key
+typedef struct
+{
+	size_t nkeys, nnodes, nchildren;
+	keyinfo_t *keys;        // Also the start of the allocation
+	trie_node_t *nodes;     // In breadth-first order, starting with the root
+	uint16_t *children;     // Node indices for the extents of array nodes
+}
+trie_t;
+
+// A sequence waiting to be compiled into the trie
+typedef struct
 {
+	const unsigned char *seq;
+	size_t order;           // Earlier definitions take precedence
 	trie_nodetype_t type;
 	keyinfo_t key;
 }
-trie_node_key_t;
+trie_entry_t;
 
-typedef struct trie_node_array
+typedef struct
 {
-	trie_nodetype_t type;
-	unsigned char min, max; // INCLUSIVE endpoints of the extent range
-	trie_node_t *arr[];     // dynamic size at allocation time
+	trie_entry_t *entries;
+	size_t len, alloc;
 }
-trie_node_array_t;
+trie_builder_t;
 
+// Sorted entries sharing a prefix of length depth, making up a single node
 typedef struct
 {
-	termo_t *tk;
-	trie_node_t *root;
+	size_t lo, hi, depth;
+}
+trie_range_t;
+
+// A terminal description compiled in advance by termo-gen-tables
+typedef struct
+{
+	const char *term;
+	bool have_mouse;
+
+	const keyinfo_t *keys;
+	size_t nkeys;
+	const trie_node_t *nodes;
+	size_t nnodes;
+	const uint16_t *children;
+	size_t nchildren;
+
+	const char *start_string;
+	const char *stop_string;
+	const char *set_mouse_string;
+}
+builtin_ti_t;
+
+// Compiling the trie is relatively expensive and all instances for the same
+// terminal would end up with identical copies, so they're shared through
+// a process-wide cache.  Entries are immutable once loaded.
+typedef struct ti_db ti_db_t;
+struct ti_db
+{
+	ti_db_t *next; // Next entry in the cache
+	unsigned refs; // Number of instances using this entry
+
+	char *term; // The terminal type this has been loaded for
+	bool have_stat; // Whether we've found the terminfo file
+	time_t mtime; // When the file has been last modified
+	ino_t ino; // In case the file has been replaced
+
+	trie_t trie;
+	bool have_mouse; // Whether key_mouse is defined
+
+	// When loaded from the on-disk cache, everything points into this mapping
+	void *map;
+	size_t map_len;
+	// When taken from the built-in tables, everything points into them
+	const builtin_ti_t *builtin;
 
 	char *start_string;
 	char *stop_string;
 
 	char *set_mouse_string;
+};
+
+static ti_db_t *ti_db_cache;
+static pthread_mutex_t ti_db_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct
+{
+	termo_t *tk;
+	ti_db_t *db;
+
+	// Where the last unfinished walk through the trie has stopped,
+	// so that sequences arriving in pieces aren't walked from the start
+	bool walk_valid;
+	size_t walk_eaten, walk_start; // Identifies the position of the walk
+	uint16_t walk_node; // 0 if the walk has found no match
+	size_t walk_pos;
 }
 termo_ti_t;
 
+// Makes sure that a trie coming from outside won't lead lookups astray
+static bool
+check_trie (const trie_t *trie)
+{
+	if (!trie->nnodes || trie->nodes[0].type != TYPE_ARRAY)
+		return false;
+
+	for (size_t i = 0; i < trie->nnodes; i++)
+	{
+		const trie_node_t *node = &trie->nodes[i];
+		switch (node->type)
+		{
+		case TYPE_KEY:
+			if (node->index >= trie->nkeys)
+				return false;
+			break;
+		case TYPE_MOUSE:
+			break;
+		case TYPE_ARRAY:
+			if (node->max < node->min)
+				break;
+			if ((size_t) node->index + node->max - node->min >= trie->nchildren)
+				return false;
+			for (int b = node->min; b <= node->max; b++)
+				if (trie->children[node->index + b - node->min] >= trie->nnodes)
+					return false;
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+static uint16_t
+lookup_next (const trie_t *trie, uint16_t node, unsigned char b)
+{
+	const trie_node_t *n = &trie->nodes[node];
+	if (n->type != TYPE_ARRAY)
+	{
+		fprintf (stderr, "fatal: lookup_next within a TYPE_KEY node\n");
+		abort ();
+	}
+
+	if (b < n->min || b > n->max)
+		return 0;
+	return trie->children[n->index + b - n->min];
+}
+
+// Looks for the compiled terminfo entry in the same places as ncurses does,
+// so that we can notice when it changes, or read it ourselves
+static bool
+find_terminfo (const char *term, char *path, size_t len, struct stat *st)
+{
+	if (!*term || strchr (term, '/'))
+		return false;
+
+	const char *home = getenv ("HOME");
+	const char *terminfo = getenv ("TERMINFO");
+	const char *terminfo_dirs = getenv ("TERMINFO_DIRS");
+
+	char dirs[4096];
+	snprintf (dirs, sizeof dirs, "%s:%s%s:%s:%s",
+		terminfo ? terminfo : "",
+		home ? home : "", home ? "/.terminfo" : "",
+		terminfo_dirs ? terminfo_dirs : "",
+		"/etc/terminfo:/lib/terminfo:/usr/share/terminfo");
+
+	for (char *dir = dirs, *end; *dir; dir = end + !!*end)
+	{
+		if (!(end = strchr (dir, ':')))
+			end = dir + strlen (dir);
+		if (end == dir)
+			continue;
+
+		int dirlen = end - dir;
+		snprintf (path, len, "%.*s/%c/%s", dirlen, dir, *term, term);
+		if (!stat (path, st))
+			return true;
+
+		// Used on filesystems that aren't case-sensitive, such as on macOS
+		snprintf (path, len, "%.*s/%02x/%s",
+			dirlen, dir, (unsigned char) *term, term);
+		if (!stat (path, st))
+			return true;
+	}
+	return false;
+}
+
+#if !defined HAVE_UNIBILIUM && !defined HAVE_CURSES \
+ && !defined HAVE_NATIVE_TERMINFO
+
+// Only the built-in tables are available
+static bool
+load_terminfo (ti_db_t *db, const char *term)
+{
+	(void) db;
+	(void) term;
+	return false;
+}
+
+#else
+
 static int funcname2keysym (const char *funcname, termo_type_t *typep,
 	termo_sym_t *symp, int *modmask, int *modsetp);
-static int insert_seq (termo_ti_t *ti, const char *seq, trie_node_t *node);
 
-static trie_node_t *
-new_node_key (termo_type_t type, termo_sym_t sym, int modmask, int modset)
+#ifdef HAVE_CURSES
+// Curses only ever works with the terminal in the global cur_term,
+// so only one thread at a time may have it replaced with another
+static pthread_mutex_t curses_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+#ifdef HAVE_NATIVE_TERMINFO
+
+// Reads compiled terminfo entries directly, as described in term(5).
+// Only the few strings that we need are ever looked at.
+
+#define TI_MAGIC_LEGACY 0432 // Numbers are 16-bit
+#define TI_MAGIC_32BIT 01036 // Numbers are 32-bit
+#define TI_MAX_FILE_SIZE 32768
+
+// Indexes of the standard string capabilities, in the order of the file
+#define TI_KEYPAD_LOCAL 88
+#define TI_KEYPAD_XMIT  89
+
+static const char *ti_key_names[] =
 {
-	trie_node_key_t *n = malloc (sizeof *n);
-	if (!n)
-		return NULL;
+	[55] = "key_backspace", [56] = "key_catab", [57] = "key_clear",
+	[58] = "key_ctab", [59] = "key_dc", [60] = "key_dl", [61] = "key_down",
+	[62] = "key_eic", [63] = "key_eol", [64] = "key_eos", [65] = "key_f0",
+	[66] = "key_f1", [67] = "key_f10", [68] = "key_f2", [69] = "key_f3",
+	[70] = "key_f4", [71] = "key_f5", [72] = "key_f6", [73] = "key_f7",
+	[74] = "key_f8", [75] = "key_f9", [76] = "key_home", [77] = "key_ic",
+	[78] = "key_il", [79] = "key_left", [80] = "key_ll", [81] = "key_npage",
+	[82] = "key_ppage", [83] = "key_right", [84] = "key_sf", [85] = "key_sr",
+	[86] = "key_stab", [87] = "key_up", [139] = "key_a1", [140] = "key_a3",
+	[141] = "key_b2", [142] = "key_c1", [143] = "key_c3", [148] = "key_btab",
+	[158] = "key_beg", [159] = "key_cancel", [160] = "key_close",
+	[161] = "key_command", [162] = "key_copy", [163] = "key_create",
+	[164] = "key_end", [165] = "key_enter", [166] = "key_exit",
+	[167] = "key_find", [168] = "key_help", [169] = "key_mark",
+	[170] = "key_message", [171] = "key_move", [172] = "key_next",
+	[173] = "key_open", [174] = "key_options", [175] = "key_previous",
+	[176] = "key_print", [177] = "key_redo", [178] = "key_reference",
+	[179] = "key_refresh", [180] = "key_replace", [181] = "key_restart",
+	[182] = "key_resume", [183] = "key_save", [184] = "key_suspend",
+	[185] = "key_undo", [186] = "key_sbeg", [187] = "key_scancel",
+	[188] = "key_scommand", [189] = "key_scopy", [190] = "key_screate",
+	[191] = "key_sdc", [192] = "key_sdl", [193] = "key_select",
+	[194] = "key_send", [195] = "key_seol", [196] = "key_sexit",
+	[197] = "key_sfind", [198] = "key_shelp", [199] = "key_shome",
+	[200] = "key_sic", [201] = "key_sleft", [202] = "key_smessage",
+	[203] = "key_smove", [204] = "key_snext", [205] = "key_soptions",
+	[206] = "key_sprevious", [207] = "key_sprint", [208] = "key_sredo",
+	[209] = "key_sreplace", [210] = "key_sright", [211] = "key_srsume",
+	[212] = "key_ssave", [213] = "key_ssuspend", [214] = "key_sundo",
+	[216] = "key_f11", [217] = "key_f12", [218] = "key_f13", [219] = "key_f14",
+	[220] = "key_f15", [221] = "key_f16", [222] = "key_f17", [223] = "key_f18",
+	[224] = "key_f19", [225] = "key_f20", [226] = "key_f21", [227] = "key_f22",
+	[228] = "key_f23", [229] = "key_f24", [230] = "key_f25", [231] = "key_f26",
+	[232] = "key_f27", [233] = "key_f28", [234] = "key_f29", [235] = "key_f30",
+	[236] = "key_f31", [237] = "key_f32", [238] = "key_f33", [239] = "key_f34",
+	[240] = "key_f35", [241] = "key_f36", [242] = "key_f37", [243] = "key_f38",
+	[244] = "key_f39", [245] = "key_f40", [246] = "key_f41", [247] = "key_f42",
+	[248] = "key_f43", [249] = "key_f44", [250] = "key_f45", [251] = "key_f46",
+	[252] = "key_f47", [253] = "key_f48", [254] = "key_f49", [255] = "key_f50",
+	[256] = "key_f51", [257] = "key_f52", [258] = "key_f53", [259] = "key_f54",
+	[260] = "key_f55", [261] = "key_f56", [262] = "key_f57", [263] = "key_f58",
+	[264] = "key_f59", [265] = "key_f60", [266] = "key_f61", [267] = "key_f62",
+	[268] = "key_f63", [355] = "key_mouse",
+};
 
-	n->type = TYPE_KEY;
-	n->key.type = type;
-	n->key.sym  = sym;
-	n->key.modifier_mask = modmask;
-	n->key.modifier_set  = modset;
-	return (trie_node_t *) n;
+typedef struct
+{
+	unsigned char *data; // The whole file
+
+	const unsigned char *offsets; // Offsets of standard strings
+	size_t nstrings; // Number of standard strings
+	const char *table; // String table for standard strings
+	size_t table_len; // Size of the string table
+
+	const unsigned char *ext_offsets; // Offsets of extended strings
+	const unsigned char *ext_names; // Offsets of their names
+	size_t next_strings; // Number of extended strings
+	const char *ext_table; // String table for extended strings
+	size_t ext_table_len; // Size of the table, including names
+	size_t ext_names_base; // Where names start within the table
 }
+ti_file_t;
 
-static trie_node_t *
-new_node_arr (unsigned char min, unsigned char max)
+static unsigned
+ti_le16 (const unsigned char *p)
 {
-	trie_node_array_t *n = malloc (sizeof *n
-		+ ((int) max - min + 1) * sizeof n->arr[0]);
-	if (!n)
+	return p[0] | p[1] << 8;
+}
+
+// Returns NULL for absent, cancelled or broken strings
+static const char *
+ti_table_string (const char *table, size_t len, const unsigned char *offset)
+{
+	unsigned off = ti_le16 (offset);
+	if (off >= 0x8000 || off >= len || !memchr (table + off, 0, len - off))
 		return NULL;
+	return table + off;
+}
+
+static void
+ti_file_parse_extended (ti_file_t *f, size_t pos, size_t len, size_t numsize)
+{
+	const unsigned char *p = f->data;
+	pos += pos & 1;
+	if (pos + 10 > len)
+		return;
+
+	size_t nbools = ti_le16 (p + pos);
+	size_t nnums = ti_le16 (p + pos + 2);
+	size_t nstrings = ti_le16 (p + pos + 4);
+	size_t nitems = ti_le16 (p + pos + 6);
+	size_t table_len = ti_le16 (p + pos + 8);
+
+	pos += 10 + nbools;
+	pos += pos & 1;
+	pos += nnums * numsize;
+
+	// Values are followed by names for all booleans, numbers and strings
+	const unsigned char *offsets = p + pos;
+	pos += nitems * 2;
+	if (pos + table_len > len || nitems != nstrings * 2 + nbools + nnums)
+		return;
+
+	// Names are stored after all the values that are present
+	const char *table = (const char *) p + pos;
+	size_t base = 0;
+	for (size_t i = 0; i < nstrings; i++)
+	{
+		const char *value = ti_table_string (table, table_len, offsets + 2 * i);
+		if (value)
+			base += strlen (value) + 1;
+	}
+	if (base > table_len)
+		return;
+
+	f->ext_offsets = offsets;
+	f->ext_names = offsets + 2 * (nstrings + nbools + nnums);
+	f->next_strings = nstrings;
+	f->ext_table = table;
+	f->ext_table_len = table_len;
+	f->ext_names_base = base;
+}
+
+static bool
+ti_file_read (ti_file_t *f, const char *term)
+{
+	memset (f, 0, sizeof *f);
+
+	char path[4096];
+	struct stat st;
+	if (!find_terminfo (term, path, sizeof path, &st)
+	 || st.st_size < 12 || st.st_size > TI_MAX_FILE_SIZE)
+		return false;
+
+	int fd = open (path, O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	size_t len = 0;
+	ssize_t got = 0;
+	if ((f->data = malloc (st.st_size)))
+		while (len < (size_t) st.st_size
+			&& (got = read (fd, f->data + len, st.st_size - len)) > 0)
+			len += got;
+	close (fd);
+
+	const unsigned char *p = f->data;
+	size_t numsize = 0;
+	if (len >= 12 && ti_le16 (p) == TI_MAGIC_LEGACY)
+		numsize = 2;
+	else if (len >= 12 && ti_le16 (p) == TI_MAGIC_32BIT)
+		numsize = 4;
+	else
+		goto fail;
 
-	n->type = TYPE_ARRAY;
-	n->min = min;
-	n->max = max;
+	size_t names_len = ti_le16 (p + 2);
+	size_t nbools = ti_le16 (p + 4);
+	size_t nnums = ti_le16 (p + 6);
+	size_t nstrings = ti_le16 (p + 8);
+	size_t table_len = ti_le16 (p + 10);
 
-	int i;
-	for (i = min; i <= max; i++)
-		n->arr[i - min] = NULL;
+	size_t pos = 12 + names_len + nbools;
+	pos += pos & 1;
+	pos += nnums * numsize;
 
-	return (trie_node_t *) n;
+	f->offsets = p + pos;
+	f->nstrings = nstrings;
+	pos += nstrings * 2;
+
+	f->table = (const char *) p + pos;
+	f->table_len = table_len;
+	if ((pos += table_len) > len)
+		goto fail;
+
+	ti_file_parse_extended (f, pos, len, numsize);
+	return true;
+
+fail:
+	free (f->data);
+	return false;
 }
 
-static trie_node_t *
-lookup_next (trie_node_t *n, unsigned char b)
+static const char *
+ti_file_string (const ti_file_t *f, size_t index)
 {
-	switch (n->type)
-	{
-	case TYPE_KEY:
-	case TYPE_MOUSE:
-		fprintf (stderr, "fatal: lookup_next within a TYPE_KEY node\n");
-		abort ();
-	case TYPE_ARRAY:
+	if (index >= f->nstrings)
+		return NULL;
+	return ti_table_string (f->table, f->table_len, f->offsets + 2 * index);
+}
+
+static const char *
+ti_file_ext_string (const ti_file_t *f, const char *name)
+{
+	for (size_t i = 0; i < f->next_strings; i++)
 	{
-		trie_node_array_t *nar = (trie_node_array_t *) n;
-		if (b < nar->min || b > nar->max)
-			return NULL;
-		return nar->arr[b - nar->min];
-	}
+		const char *s = ti_table_string (f->ext_table + f->ext_names_base,
+			f->ext_table_len - f->ext_names_base, f->ext_names + 2 * i);
+		if (s && !strcmp (s, name))
+			return ti_table_string (f->ext_table, f->ext_table_len,
+				f->ext_offsets + 2 * i);
 	}
-	return NULL;  // Never reached but keeps compiler happy
+	return NULL;
 }
 
-static void
-free_trie (trie_node_t *n)
+#endif
+
+static bool
+add_seq (trie_builder_t *b, const char *seq,
+	trie_nodetype_t type, const keyinfo_t *key)
 {
-	switch (n->type)
-	{
-	case TYPE_KEY:
-	case TYPE_MOUSE:
-		break;
-	case TYPE_ARRAY:
+	if (!*seq)
+		return true;
+
+	if (b->len == b->alloc)
 	{
-		trie_node_array_t *nar = (trie_node_array_t *) n;
-		int i;
-		for (i = nar->min; i <= nar->max; i++)
-			if (nar->arr[i - nar->min])
-				free_trie (nar->arr[i - nar->min]);
-	}
+		size_t alloc = b->alloc ? b->alloc << 1 : 64;
+		trie_entry_t *entries = realloc (b->entries, alloc * sizeof *entries);
+		if (!entries)
+			return false;
+
+		b->entries = entries;
+		b->alloc = alloc;
 	}
-	free (n);
+
+	trie_entry_t *e = &b->entries[b->len];
+	e->seq = (const unsigned char *) seq;
+	e->order = b->len++;
+	e->type = type;
+	if (key)
+		e->key = *key;
+	return true;
 }
 
-static trie_node_t *
-compress_trie (struct trie_node *n)
+static int
+entry_compare (const void *a, const void *b)
 {
-	if (!n)
-		return NULL;
+	const trie_entry_t *ea = a, *eb = b;
+	int cmp = strcmp ((const char *) ea->seq, (const char *) eb->seq);
+	if (cmp)
+		return cmp;
+	return (ea->order > eb->order) - (ea->order < eb->order);
+}
 
-	switch (n->type)
-	{
-	case TYPE_KEY:
-	case TYPE_MOUSE:
-		return n;
-	case TYPE_ARRAY:
+// Walks the sorted entries breadth-first, which makes the queue itself
+// the list of nodes.  Only counts things when there's no trie to fill in.
+static size_t
+layout_trie (const trie_builder_t *b, trie_range_t *queue, trie_t *trie,
+	size_t *nchildren, size_t *nkeys)
+{
+	size_t head = 0, tail = 0;
+	*nchildren = *nkeys = 0;
+
+	queue[tail++] = (trie_range_t) { 0, b->len, 0 };
+	while (head < tail)
 	{
-		trie_node_array_t *nar = (trie_node_array_t *) n;
-		// Find the real bounds
-		unsigned char min, max;
-		for (min = 0; !nar->arr[min]; min++)
-			;
-		for (max = 0xff; !nar->arr[max]; max--)
-			;
-
-		trie_node_array_t *new = (trie_node_array_t *) new_node_arr (min, max);
-		int i;
-		for (i = min; i <= max; i++)
-			new->arr[i - min] = compress_trie (nar->arr[i]);
-
-		free (nar);
-		return (trie_node_t *) new;
-	}
+		trie_range_t r = queue[head];
+		trie_node_t *node = trie ? &trie->nodes[head] : NULL;
+		head++;
+
+		// Sequences ending here are sorted first, the earliest definition
+		// wins, and nothing can continue beyond a leaf
+		const trie_entry_t *first = &b->entries[r.lo];
+		if (r.lo < r.hi && !first->seq[r.depth])
+		{
+			if (node)
+			{
+				node->type = first->type;
+				node->min = node->max = 0;
+				node->index = *nkeys;
+			}
+			if (first->type == TYPE_KEY)
+			{
+				if (trie)
+					trie->keys[*nkeys] = first->key;
+				(*nkeys)++;
+			}
+			continue;
+		}
+
+		// An empty extent for an empty root
+		unsigned char min = 1, max = 0;
+		if (r.lo < r.hi)
+		{
+			min = b->entries[r.lo].seq[r.depth];
+			max = b->entries[r.hi - 1].seq[r.depth];
+		}
+
+		size_t base = *nchildren;
+		if (max >= min)
+			*nchildren += max - min + 1;
+		if (node)
+		{
+			node->type = TYPE_ARRAY;
+			node->min = min;
+			node->max = max;
+			node->index = base;
+			memset (trie->children + base, 0,
+				(*nchildren - base) * sizeof *trie->children);
+		}
+
+		for (size_t lo = r.lo, hi; lo < r.hi; lo = hi)
+		{
+			unsigned char c = b->entries[lo].seq[r.depth];
+			for (hi = lo + 1; hi < r.hi && b->entries[hi].seq[r.depth] == c; )
+				hi++;
+
+			if (trie)
+				trie->children[base + c - min] = tail;
+			queue[tail++] = (trie_range_t) { lo, hi, r.depth + 1 };
+		}
 	}
-	return n;
+	return tail;
 }
 
 static bool
-load_terminfo (termo_ti_t *ti, const char *term)
+compile_trie (trie_builder_t *b, trie_t *trie)
+{
+	qsort (b->entries, b->len, sizeof *b->entries, entry_compare);
+
+	// Every node but the root stands for a prefix of some sequence
+	size_t max_nodes = 1;
+	for (size_t i = 0; i < b->len; i++)
+		max_nodes += strlen ((const char *) b->entries[i].seq);
+
+	trie_range_t *queue = malloc (max_nodes * sizeof *queue);
+	if (!queue)
+		return false;
+
+	size_t nnodes, nchildren, nkeys;
+	nnodes = layout_trie (b, queue, NULL, &nchildren, &nkeys);
+
+	bool result = false;
+	if (nnodes > UINT16_MAX + 1 || nchildren > UINT16_MAX + 1)
+		goto out;
+
+	// Keys have the strictest alignment requirements, so they go first
+	if (!(trie->keys = malloc (nkeys * sizeof *trie->keys
+		+ nnodes * sizeof *trie->nodes + nchildren * sizeof *trie->children)))
+		goto out;
+
+	trie->nkeys = nkeys;
+	trie->nnodes = nnodes;
+	trie->nchildren = nchildren;
+	trie->nodes = (trie_node_t *) (trie->keys + nkeys);
+	trie->children = (uint16_t *) (trie->nodes + nnodes);
+	(void) layout_trie (b, queue, trie, &nchildren, &nkeys);
+	result = true;
+
+out:
+	free (queue);
+	return result;
+}
+
+static bool
+load_terminfo (ti_db_t *db, const char *term)
 {
 	const char *mouse_report_string = NULL;
+	trie_builder_t builder = { NULL, 0, 0 };
 	bool result = false;
 
 #ifdef HAVE_UNIBILIUM
@@ -188,14 +639,25 @@ load_terminfo (termo_ti_t *ti, const char *term)
 	{
 		const char *name = unibi_name_str (i);
 		const char *value = unibi_get_str (unibi, i);
+#elif defined HAVE_NATIVE_TERMINFO
+	ti_file_t file;
+	if (!ti_file_read (&file, term))
+		return false;
+
+	for (size_t i = 0; i < sizeof ti_key_names / sizeof *ti_key_names; i++)
+	{
+		const char *name = ti_key_names[i] ? ti_key_names[i] : "";
+		const char *value = ti_file_string (&file, i);
 #else
 	// Have to cast away the const. But it's OK - we know terminfo won't
 	// really modify term
 	int err;
+	pthread_mutex_lock (&curses_lock);
 	TERMINAL *saved_term = set_curterm (NULL);
 	if (setupterm ((char *) term, 1, &err) != OK)
 	{
 		set_curterm (saved_term);
+		pthread_mutex_unlock (&curses_lock);
 		return false;
 	}
 
@@ -210,30 +672,22 @@ load_terminfo (termo_ti_t *ti, const char *term)
 		if (!value || value == (char*) -1)
 			continue;
 
-		trie_node_t *node = NULL;
 		if (!strcmp (name + 4, "mouse"))
-			mouse_report_string = value;
-		else
 		{
-			termo_type_t type;
-			termo_sym_t sym;
-			int mask = 0;
-			int set = 0;
-
-			if (!funcname2keysym (name + 4, &type, &sym, &mask, &set))
-				continue;
+			mouse_report_string = value;
+			continue;
+		}
 
-			if (sym == TERMO_SYM_NONE)
-				continue;
+		keyinfo_t key = { .modifier_mask = 0, .modifier_set = 0 };
+		if (!funcname2keysym (name + 4, &key.type, &key.sym,
+			&key.modifier_mask, &key.modifier_set))
+			continue;
 
-			node = new_node_key (type, sym, mask, set);
-		}
+		if (key.sym == TERMO_SYM_NONE)
+			continue;
 
-		if (node && !insert_seq (ti, value, node))
-		{
-			free (node);
+		if (!add_seq (&builder, value, TYPE_KEY, &key))
 			goto fail;
-		}
 	}
 
 	// Clone the behaviour of ncurses for xterm mouse support
@@ -242,81 +696,485 @@ load_terminfo (termo_ti_t *ti, const char *term)
 	size_t xm = unibi_add_ext_str (unibi, "XM", NULL);
 	if (xm != SIZE_MAX)
 		set_mouse_string = unibi_get_ext_str (unibi, xm);
+#elif defined HAVE_NATIVE_TERMINFO
+	set_mouse_string = ti_file_ext_string (&file, "XM");
 #else
 	set_mouse_string = tigetstr ("XM");
 #endif
 	if (!set_mouse_string || set_mouse_string == (char *) -1)
-		ti->set_mouse_string = strdup ("\x1b[?1000%?%p1%{1}%=%th%el%;");
+		db->set_mouse_string = strdup ("\x1b[?1000%?%p1%{1}%=%th%el%;");
 	else
-		ti->set_mouse_string = strdup (set_mouse_string);
+		db->set_mouse_string = strdup (set_mouse_string);
 
 	// We handle 1006 and 1015 unconditionally in driver-csi.c,
 	// and don't want to have the handling diverted by recent terminfo;
 	// let's hardcode the ancient 1000 sequence locally
-	if (mouse_report_string)
-	{
-		trie_node_t *node = malloc (sizeof *node);
-		if (!node)
-			goto fail;
-
-		node->type = TYPE_MOUSE;
-		if (!insert_seq (ti, "\x1b[M", node))
-		{
-			free (node);
-			goto fail;
-		}
-	}
-
-	if (!mouse_report_string && strstr (term, "xterm") != term)
-		ti->tk->guessed_mouse_proto = TERMO_MOUSE_PROTO_NONE;
-	else if (strstr (term, "rxvt") == term)
-		// urxvt didn't understand the SGR protocol until version 9.25,
-		// it's safest to keep using 1015.
-		ti->tk->guessed_mouse_proto = TERMO_MOUSE_PROTO_RXVT;
-	else
-		// SGR (1006) is the superior protocol.  If it's not supported by the
-		// terminal, nothing much happens and we continue getting events via
-		// the original protocol (1000).  We can't afford to enable the UTF-8
-		// protocol (1005) because it collides with the original (1000) and we
-		// have no way of knowing if it's supported by the terminal.  Also both
-		// 1000 and 1005 are broken in that they may produce characters that
-		// are illegal in the current locale's charset.
-		ti->tk->guessed_mouse_proto = TERMO_MOUSE_PROTO_SGR;
+	if (mouse_report_string
+	 && !add_seq (&builder, "\x1b[M", TYPE_MOUSE, NULL))
+		goto fail;
+	db->have_mouse = mouse_report_string != NULL;
 
-	// Preset the active protocol to our wild guess
-	ti->tk->mouse_proto = ti->tk->guessed_mouse_proto;
+	// The values are only valid until we're done with the database
+	if (!compile_trie (&builder, &db->trie))
+		goto fail;
 
 	// Take copies of these terminfo strings, in case we build multiple termo
 	// instances for multiple different termtypes, and it's different by the
 	// time we want to use it
 #ifdef HAVE_UNIBILIUM
 	const char *keypad_xmit = unibi_get_str (unibi, unibi_keypad_xmit);
+#elif defined HAVE_NATIVE_TERMINFO
+	const char *keypad_xmit = ti_file_string (&file, TI_KEYPAD_XMIT);
 #endif
 
 	if (keypad_xmit)
-		ti->start_string = strdup (keypad_xmit);
+		db->start_string = strdup (keypad_xmit);
 	else
-		ti->start_string = NULL;
+		db->start_string = NULL;
 
 #ifdef HAVE_UNIBILIUM
 	const char *keypad_local = unibi_get_str (unibi, unibi_keypad_local);
+#elif defined HAVE_NATIVE_TERMINFO
+	const char *keypad_local = ti_file_string (&file, TI_KEYPAD_LOCAL);
 #endif
 
 	if (keypad_local)
-		ti->stop_string = strdup (keypad_local);
+		db->stop_string = strdup (keypad_local);
 	else
-		ti->stop_string = NULL;
+		db->stop_string = NULL;
 
 	result = true;
 fail:
+	free (builder.entries);
 #ifdef HAVE_UNIBILIUM
 	unibi_destroy (unibi);
+#elif defined HAVE_NATIVE_TERMINFO
+	free (file.data);
 #else
 	del_curterm (set_curterm (saved_term));
+	pthread_mutex_unlock (&curses_lock);
 #endif
 	return result;
 }
 
+#endif
+
+static void
+free_db (ti_db_t *db)
+{
+	if (db->map)
+		munmap (db->map, db->map_len);
+	else if (!db->builtin)
+	{
+		free (db->trie.keys);
+		free (db->set_mouse_string);
+		free (db->start_string);
+		free (db->stop_string);
+	}
+	free (db->term);
+	free (db);
+}
+
+// - - - On-disk cache - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// To save even the terminfo lookup and parsing in new processes, compiled
+// entries are also stored in $XDG_CACHE_HOME/termo/$TERM.  The file is
+// a header followed by the trie's keys, nodes, children and strings, with
+// everything referred to by indices and offsets so that it can be mapped.
+
+#define TI_CACHE_MAGIC "termo-ti"
+#define TI_CACHE_VERSION 1
+#define TI_CACHE_NO_STRING UINT32_MAX
+
+typedef struct
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t abi; // Byte order and sizes of the structures, see cache_abi()
+
+	// Identity of the terminfo file the entry has been compiled from
+	int64_t mtime;
+	uint64_t ino;
+	int64_t size;
+
+	uint32_t nkeys, nnodes, nchildren, strings_len;
+	uint32_t start_string, stop_string, set_mouse_string; // String offsets
+	uint32_t have_mouse;
+}
+ti_cache_header_t;
+
+static uint32_t
+cache_abi (void)
+{
+	// The first byte in memory will differ between byte orders
+	return 0x01000000 | sizeof (keyinfo_t) << 8 | sizeof (trie_node_t);
+}
+
+static bool
+cache_path (const char *term, char *path, size_t len, bool create)
+{
+	const char *xdg = getenv ("XDG_CACHE_HOME");
+	const char *home = getenv ("HOME");
+
+	// Don't let the environment make us write files with elevated privileges
+	if (getuid () != geteuid () || getgid () != getegid ())
+		return false;
+
+	int n;
+	if (xdg && *xdg == '/')
+		n = snprintf (path, len, "%s", xdg);
+	else if (home && *home == '/')
+		n = snprintf (path, len, "%s/.cache", home);
+	else
+		return false;
+	if (n < 0 || (size_t) n + sizeof "/termo/" + strlen (term) > len)
+		return false;
+
+	if (create)
+		(void) mkdir (path, 0700);
+
+	n += sprintf (path + n, "/termo");
+	if (create)
+		(void) mkdir (path, 0755);
+
+	sprintf (path + n, "/%s", term);
+	return true;
+}
+
+static const char *
+map_string (const char *strings, uint32_t offset)
+{
+	return offset == TI_CACHE_NO_STRING ? NULL : strings + offset;
+}
+
+// Takes `count' items of `size' bytes from the `left' bytes of a cache file
+static bool
+take_cached (size_t *left, size_t count, size_t size)
+{
+	if (count > SIZE_MAX / size || count * size > *left)
+		return false;
+
+	*left -= count * size;
+	return true;
+}
+
+static ti_db_t *
+load_cached_db (const char *term, const struct stat *st)
+{
+	char path[4096];
+	if (!cache_path (term, path, sizeof path, false))
+		return NULL;
+
+	int fd = open (path, O_RDONLY);
+	if (fd == -1)
+		return NULL;
+
+	struct stat cache_st;
+	void *map = MAP_FAILED;
+	if (!fstat (fd, &cache_st)
+	 && (size_t) cache_st.st_size >= sizeof (ti_cache_header_t))
+		map = mmap (NULL, cache_st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close (fd);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	size_t len = cache_st.st_size;
+	const ti_cache_header_t *h = map;
+	if (memcmp (h->magic, TI_CACHE_MAGIC, sizeof h->magic)
+	 || h->version != TI_CACHE_VERSION || h->abi != cache_abi ()
+	 || h->mtime != (int64_t) st->st_mtime || h->ino != (uint64_t) st->st_ino
+	 || h->size != (int64_t) st->st_size)
+		goto fail;
+
+	// Each part has to fit in what is left of the file,
+	// the counts may be large enough to overflow with 32-bit size_t
+	size_t left = len - sizeof *h;
+	if (!take_cached (&left, h->nkeys, sizeof (keyinfo_t))
+	 || !take_cached (&left, h->nnodes, sizeof (trie_node_t))
+	 || !take_cached (&left, h->nchildren, sizeof (uint16_t))
+	 || left != h->strings_len)
+		goto fail;
+
+	const char *strings = (const char *) map + len - h->strings_len;
+	uint32_t offsets[] = { h->start_string, h->stop_string, h->set_mouse_string };
+	for (size_t i = 0; i < sizeof offsets / sizeof *offsets; i++)
+		if (offsets[i] != TI_CACHE_NO_STRING
+		 && (offsets[i] >= h->strings_len || strings[h->strings_len - 1]))
+			goto fail;
+	if (h->set_mouse_string == TI_CACHE_NO_STRING)
+		goto fail;
+
+	ti_db_t *db = calloc (1, sizeof *db);
+	if (!db)
+		goto fail;
+
+	db->map = map;
+	db->map_len = len;
+
+	db->trie.nkeys = h->nkeys;
+	db->trie.nnodes = h->nnodes;
+	db->trie.nchildren = h->nchildren;
+	db->trie.keys = (keyinfo_t *) (h + 1);
+	db->trie.nodes = (trie_node_t *) (db->trie.keys + h->nkeys);
+	db->trie.children = (uint16_t *) (db->trie.nodes + h->nnodes);
+
+	db->have_mouse = h->have_mouse;
+	db->start_string = (char *) map_string (strings, h->start_string);
+	db->stop_string = (char *) map_string (strings, h->stop_string);
+	db->set_mouse_string = (char *) map_string (strings, h->set_mouse_string);
+
+	if (!check_trie (&db->trie) || !(db->term = strdup (term)))
+	{
+		free_db (db);
+		return NULL;
+	}
+	return db;
+
+fail:
+	munmap (map, len);
+	return NULL;
+}
+
+static bool
+write_all (int fd, const void *data, size_t len)
+{
+	const char *p = data;
+	while (len)
+	{
+		ssize_t written = write (fd, p, len);
+		if (written == -1)
+			return false;
+		p += written;
+		len -= written;
+	}
+	return true;
+}
+
+static uint32_t
+add_cached_string (char *strings, uint32_t *len, const char *string)
+{
+	if (!string)
+		return TI_CACHE_NO_STRING;
+
+	uint32_t offset = *len;
+	strcpy (strings + offset, string);
+	*len += strlen (string) + 1;
+	return offset;
+}
+
+// Failing to save the cache is of no consequence, so errors are ignored
+static void
+save_cached_db (const ti_db_t *db, const struct stat *st)
+{
+	char path[4096], tmp[4096 + 8];
+	if (!cache_path (db->term, path, sizeof path, true))
+		return;
+
+	const char *all[] = { db->start_string, db->stop_string,
+		db->set_mouse_string };
+	size_t strings_alloc = 0;
+	for (size_t i = 0; i < sizeof all / sizeof *all; i++)
+		if (all[i])
+			strings_alloc += strlen (all[i]) + 1;
+
+	char *strings = malloc (strings_alloc);
+	if (!strings)
+		return;
+
+	ti_cache_header_t h;
+	memset (&h, 0, sizeof h);
+	memcpy (h.magic, TI_CACHE_MAGIC, sizeof h.magic);
+	h.version = TI_CACHE_VERSION;
+	h.abi = cache_abi ();
+	h.mtime = st->st_mtime;
+	h.ino = st->st_ino;
+	h.size = st->st_size;
+	h.nkeys = db->trie.nkeys;
+	h.nnodes = db->trie.nnodes;
+	h.nchildren = db->trie.nchildren;
+	h.have_mouse = db->have_mouse;
+	h.start_string = add_cached_string (strings, &h.strings_len, all[0]);
+	h.stop_string = add_cached_string (strings, &h.strings_len, all[1]);
+	h.set_mouse_string = add_cached_string (strings, &h.strings_len, all[2]);
+
+	// Write it out atomically, so that readers never see a partial file
+	snprintf (tmp, sizeof tmp, "%s.XXXXXX", path);
+	int fd = mkstemp (tmp);
+	if (fd == -1)
+		goto out;
+
+	bool ok = write_all (fd, &h, sizeof h)
+		&& write_all (fd, db->trie.keys, db->trie.nkeys * sizeof (keyinfo_t))
+		&& write_all (fd, db->trie.nodes, db->trie.nnodes * sizeof (trie_node_t))
+		&& write_all (fd, db->trie.children,
+			db->trie.nchildren * sizeof (uint16_t))
+		&& write_all (fd, strings, h.strings_len)
+		&& !fchmod (fd, 0644);
+	if (close (fd) || !ok || rename (tmp, path))
+		unlink (tmp);
+
+out:
+	free (strings);
+}
+
+// - - - Built-in tables - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+#ifdef TERMO_GEN_TABLES
+static const builtin_ti_t builtin_ti[] = {{ NULL }};
+#else
+#include "driver-ti-tables.h"
+#endif
+
+static const builtin_ti_t *
+find_builtin (const char *term)
+{
+	for (const builtin_ti_t *b = builtin_ti; b->term; b++)
+		if (!strcmp (b->term, term))
+			return b;
+	return NULL;
+}
+
+static ti_db_t *
+load_builtin_db (const builtin_ti_t *builtin)
+{
+	ti_db_t *db = calloc (1, sizeof *db);
+	if (!db)
+		return NULL;
+
+	if (!(db->term = strdup (builtin->term)))
+	{
+		free (db);
+		return NULL;
+	}
+
+	// The tables are never written to, the casts are only to share types
+	db->builtin = builtin;
+	db->have_mouse = builtin->have_mouse;
+	db->trie.nkeys = builtin->nkeys;
+	db->trie.keys = (keyinfo_t *) builtin->keys;
+	db->trie.nnodes = builtin->nnodes;
+	db->trie.nodes = (trie_node_t *) builtin->nodes;
+	db->trie.nchildren = builtin->nchildren;
+	db->trie.children = (uint16_t *) builtin->children;
+	db->start_string = (char *) builtin->start_string;
+	db->stop_string = (char *) builtin->stop_string;
+	db->set_mouse_string = (char *) builtin->set_mouse_string;
+	return db;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static ti_db_t *
+load_db (const char *term, const struct stat *st)
+{
+	ti_db_t *db;
+	if (st && (db = load_cached_db (term, st)))
+		return db;
+
+	if (!(db = calloc (1, sizeof *db)))
+		return NULL;
+
+	if (!(db->term = strdup (term))
+	 || !load_terminfo (db, term))
+	{
+		free_db (db);
+		return NULL;
+	}
+
+	if (st)
+		save_cached_db (db, st);
+	return db;
+}
+
+// Looks for an up-to-date entry in the cache, with ti_db_cache_lock held
+static ti_db_t *
+find_cached_db (const char *term, const builtin_ti_t *builtin,
+	bool have_stat, const struct stat *st)
+{
+	for (ti_db_t *db = ti_db_cache; db; db = db->next)
+	{
+		if (strcmp (db->term, term) || db->builtin != builtin
+		 || db->have_stat != have_stat)
+			continue;
+		if (!have_stat || (db->mtime == st->st_mtime && db->ino == st->st_ino))
+			return db;
+	}
+	return NULL;
+}
+
+// Returns a reference to the loaded terminfo entry for the terminal,
+// loading it only if there's no up-to-date copy in the cache yet.
+// The lock isn't held while loading, so that other threads aren't held up.
+static ti_db_t *
+acquire_db (const char *term)
+{
+	// Built-in tables take precedence, so that there's no I/O at all
+	const builtin_ti_t *builtin = find_builtin (term);
+
+	char path[4096];
+	struct stat st;
+	bool have_stat = !builtin && find_terminfo (term, path, sizeof path, &st);
+
+	pthread_mutex_lock (&ti_db_cache_lock);
+	ti_db_t *db = find_cached_db (term, builtin, have_stat, &st);
+	if (db)
+	{
+		db->refs++;
+		pthread_mutex_unlock (&ti_db_cache_lock);
+		return db;
+	}
+	pthread_mutex_unlock (&ti_db_cache_lock);
+
+	ti_db_t *loaded;
+	if (builtin)
+		loaded = load_builtin_db (builtin);
+	else
+		loaded = load_db (term, have_stat ? &st : NULL);
+	if (!loaded)
+		return NULL;
+
+	loaded->have_stat = have_stat;
+	if (have_stat)
+	{
+		loaded->mtime = st.st_mtime;
+		loaded->ino = st.st_ino;
+	}
+
+	// Another thread may have been loading the same entry meanwhile
+	pthread_mutex_lock (&ti_db_cache_lock);
+	if (!(db = find_cached_db (term, builtin, have_stat, &st)))
+	{
+		db = loaded;
+		db->next = ti_db_cache;
+		ti_db_cache = db;
+		loaded = NULL;
+	}
+	db->refs++;
+	pthread_mutex_unlock (&ti_db_cache_lock);
+
+	if (loaded)
+		free_db (loaded);
+	return db;
+}
+
+static void
+release_db (ti_db_t *db)
+{
+	pthread_mutex_lock (&ti_db_cache_lock);
+	bool last = !--db->refs;
+	if (last)
+	{
+		ti_db_t **p = &ti_db_cache;
+		while (*p != db)
+			p = &(*p)->next;
+		*p = db->next;
+	}
+	pthread_mutex_unlock (&ti_db_cache_lock);
+
+	if (last)
+		free_db (db);
+}
+
 static bool
 write_string (termo_t *tk, char *string)
 {
@@ -344,12 +1202,25 @@ set_mouse (termo_ti_t *ti, bool enable)
 {
 #ifdef HAVE_UNIBILIUM
 	unibi_var_t params[9] = { enable, 0, 0, 0, 0, 0, 0, 0, 0 };
-	char start_string[unibi_run (ti->set_mouse_string, params, NULL, 0) + 1];
-	start_string[unibi_run (ti->set_mouse_string, params,
+	char start_string[unibi_run (ti->db->set_mouse_string, params, NULL, 0) + 1];
+	start_string[unibi_run (ti->db->set_mouse_string, params,
 		start_string, sizeof start_string - 1)] = 0;
-#else
-	char *start_string = tparm (ti->set_mouse_string,
+#elif defined HAVE_CURSES
+	char *start_string = tparm (ti->db->set_mouse_string,
 		enable, 0, 0, 0, 0, 0, 0, 0, 0);
+#else
+	// Without a terminfo library, only handle the usual form of the string
+	static const char suffix[] = "%?%p1%{1}%=%th%el%;";
+	const char *s = ti->db->set_mouse_string;
+	size_t prefix_len = strlen (s);
+	if (prefix_len < sizeof suffix - 1
+	 || strcmp (s + (prefix_len -= sizeof suffix - 1), suffix))
+		return true;
+
+	char start_string[prefix_len + 2];
+	memcpy (start_string, s, prefix_len);
+	start_string[prefix_len] = enable ? 'h' : 'l';
+	start_string[prefix_len + 1] = 0;
 #endif
 	return write_string (ti->tk, start_string);
 }
@@ -397,11 +1268,38 @@ mouse_set_proto (void *data, termo_mouse_proto_t proto, bool enable)
 	return true;
 }
 
+static bool
+set_keyboard_flags (void *data, int flags, bool enable)
+{
+	termo_ti_t *ti = data;
+	if (!flags)
+		return true;
+	if (!enable)
+		return write_string (ti->tk, "\x1b[<u");
+
+	// Terminals that don't know the kitty keyboard protocol ignore both,
+	// those that do reply with CSI ? flags u
+	char push[32];
+	snprintf (push, sizeof push, "\x1b[>%du\x1b[?u", flags);
+	return write_string (ti->tk, push);
+}
+
+static bool
+set_bracketed_paste (void *data, bool enable)
+{
+	termo_ti_t *ti = data;
+	return write_string (ti->tk, enable ? "\x1b[?2004h" : "\x1b[?2004l");
+}
+
 static int
 start_driver (termo_t *tk, void *info)
 {
 	termo_ti_t *ti = info;
-	if (!write_string (tk, ti->start_string))
+	if (!write_string (tk, ti->db->start_string))
+		return false;
+	if ((tk->flags & TERMO_FLAG_PASTE) && !set_bracketed_paste (ti, true))
+		return false;
+	if (!set_keyboard_flags (ti, tk->keyboard_flags, true))
 		return false;
 
 	// If there's no protocol, it doesn't make sense to try anything else
@@ -423,7 +1321,11 @@ static int
 stop_driver (termo_t *tk, void *info)
 {
 	termo_ti_t *ti = info;
-	if (!write_string (tk, ti->stop_string))
+	if (!write_string (tk, ti->db->stop_string))
+		return false;
+	if ((tk->flags & TERMO_FLAG_PASTE) && !set_bracketed_paste (ti, false))
+		return false;
+	if (!set_keyboard_flags (ti, tk->keyboard_flags, false))
 		return false;
 
 	// If there's no protocol, it doesn't make sense to try anything else
@@ -442,26 +1344,37 @@ new_driver (termo_t *tk, const char *term)
 		return NULL;
 
 	ti->tk = tk;
-	ti->root = new_node_arr (0, 0xff);
-	if (!ti->root)
-		goto abort_free_ti;
+	if (!(ti->db = acquire_db (term)))
+	{
+		free (ti);
+		return NULL;
+	}
 
-	if (!load_terminfo (ti, term))
-		goto abort_free_trie;
+	if (!ti->db->have_mouse && strstr (term, "xterm") != term)
+		tk->guessed_mouse_proto = TERMO_MOUSE_PROTO_NONE;
+	else if (strstr (term, "rxvt") == term)
+		// urxvt didn't understand the SGR protocol until version 9.25,
+		// it's safest to keep using 1015.
+		tk->guessed_mouse_proto = TERMO_MOUSE_PROTO_RXVT;
+	else
+		// SGR (1006) is the superior protocol.  If it's not supported by the
+		// terminal, nothing much happens and we continue getting events via
+		// the original protocol (1000).  We can't afford to enable the UTF-8
+		// protocol (1005) because it collides with the original (1000) and we
+		// have no way of knowing if it's supported by the terminal.  Also both
+		// 1000 and 1005 are broken in that they may produce characters that
+		// are illegal in the current locale's charset.
+		tk->guessed_mouse_proto = TERMO_MOUSE_PROTO_SGR;
 
-	ti->root = compress_trie (ti->root);
+	// Preset the active protocol to our wild guess
+	tk->mouse_proto = tk->guessed_mouse_proto;
 
 	tk->ti_data = ti;
 	tk->ti_method.set_mouse_proto = mouse_set_proto;
 	tk->ti_method.set_mouse_tracking_mode = mouse_set_tracking_mode;
+	tk->ti_method.set_keyboard_flags = set_keyboard_flags;
+	tk->ti_method.set_bracketed_paste = set_bracketed_paste;
 	return ti;
-
-abort_free_trie:
-	free_trie (ti->root);
-
-abort_free_ti:
-	free (ti);
-	return NULL;
 }
 
 static void
@@ -471,16 +1384,13 @@ free_driver (void *info)
 	ti->tk->ti_data = NULL;
 	ti->tk->ti_method.set_mouse_proto = NULL;
 	ti->tk->ti_method.set_mouse_tracking_mode = NULL;
+	ti->tk->ti_method.set_keyboard_flags = NULL;
+	ti->tk->ti_method.set_bracketed_paste = NULL;
 
-	free_trie (ti->root);
-	free (ti->set_mouse_string);
-	free (ti->start_string);
-	free (ti->stop_string);
+	release_db (ti->db);
 	free (ti);
 }
 
-#define CHARAT(i) (tk->buffer[tk->buffstart + (i)])
-
 static termo_result_t
 peekkey (termo_t *tk, void *info,
 	termo_key_t *key, int flags, size_t *nbytep)
@@ -490,35 +1400,43 @@ peekkey (termo_t *tk, void *info,
 	if (tk->buffcount == 0)
 		return tk->is_closed ? TERMO_RES_EOF : TERMO_RES_NONE;
 
-	trie_node_t *p = ti->root;
-	unsigned int pos = 0;
+	const trie_t *trie = &ti->db->trie;
+	uint16_t p = 0;
+	size_t pos = 0;
+	if (ti->walk_valid
+	 && ti->walk_eaten == tk->eaten && ti->walk_start == tk->buffstart)
+	{
+		if (!(p = ti->walk_node))
+			return TERMO_RES_NONE;
+		pos = ti->walk_pos;
+	}
+
 	while (pos < tk->buffcount)
 	{
-		p = lookup_next (p, CHARAT (pos));
+		p = lookup_next (trie, p, CHARAT (pos));
 		if (!p)
 			break;
 
 		pos++;
 
-		if (p->type == TYPE_KEY)
+		const trie_node_t *node = &trie->nodes[p];
+		if (node->type == TYPE_KEY)
 		{
-			trie_node_key_t *nk = (trie_node_key_t *) p;
-			key->type      = nk->key.type;
-			key->code.sym  = nk->key.sym;
-			key->modifiers = nk->key.modifier_set;
+			const keyinfo_t *nk = &trie->keys[node->index];
+			key->type      = nk->type;
+			key->code.sym  = nk->sym;
+			key->modifiers = nk->modifier_set;
 			*nbytep = pos;
 			return TERMO_RES_KEY;
 		}
-		else if (p->type == TYPE_MOUSE)
+		else if (node->type == TYPE_MOUSE)
 		{
-			tk->buffstart += pos;
-			tk->buffcount -= pos;
+			hide_bytes (tk, pos);
 
 			termo_result_t mouse_result =
 				(*tk->method.peekkey_mouse) (tk, key, nbytep);
 
-			tk->buffstart -= pos;
-			tk->buffcount += pos;
+			unhide_bytes (tk, pos);
 
 			if (mouse_result == TERMO_RES_KEY)
 				*nbytep += pos;
@@ -527,7 +1445,13 @@ peekkey (termo_t *tk, void *info,
 		}
 	}
 
-	// If p is not NULL then we hadn't walked off the end yet, so we have a
+	ti->walk_valid = true;
+	ti->walk_eaten = tk->eaten;
+	ti->walk_start = tk->buffstart;
+	ti->walk_node = p;
+	ti->walk_pos = pos;
+
+	// If p is not 0 then we hadn't walked off the end yet, so we have a
 	// partial match
 	if (p && !(flags & PEEKKEY_FORCE))
 		return TERMO_RES_AGAIN;
@@ -535,6 +1459,9 @@ peekkey (termo_t *tk, void *info,
 	return TERMO_RES_NONE;
 }
 
+#if defined HAVE_UNIBILIUM || defined HAVE_CURSES \
+ || defined HAVE_NATIVE_TERMINFO
+
 static struct func
 {
 	const char *funcname;
@@ -637,70 +1564,70 @@ funcname2keysym (const char *funcname,
 	return 0;
 }
 
-static int
-insert_seq (termo_ti_t *ti, const char *seq, trie_node_t *node)
+#endif
+
+static bool
+starts_sequence (void *info, unsigned char byte)
 {
-	int pos = 0;
-	trie_node_t *p = ti->root;
+	termo_ti_t *ti = info;
+	return lookup_next (&ti->db->trie, 0, byte) != 0;
+}
 
-	// Unsigned because we'll be using it as an array subscript
-	unsigned char b;
+// Terminfo strings for keys are short, anything longer is left to peekkey()
+#define TI_MAX_SEQUENCE 32
 
-	while ((b = seq[pos]))
+static bool
+add_node_sequences (termo_t *tk, const trie_t *trie, uint16_t node,
+	unsigned char *seq, size_t depth, automaton_builder_t *b)
+{
+	const trie_node_t *n = &trie->nodes[node];
+	if (n->type == TYPE_KEY)
 	{
-		trie_node_t *next = lookup_next (p, b);
-		if (!next)
-			break;
-		p = next;
-		pos++;
+		(*tk->method.add_sequence) (b, seq, depth,
+			AUTOMATON_KEY, &trie->keys[n->index]);
+		return true;
+	}
+	if (n->type == TYPE_MOUSE)
+	{
+		(*tk->method.add_sequence) (b, seq, depth, AUTOMATON_MOUSE, NULL);
+		return true;
 	}
+	if (depth == TI_MAX_SEQUENCE)
+		return false;
 
-	while ((b = seq[pos]))
+	bool described = true, dead_end = true;
+	for (int c = n->min; c <= n->max; c++)
 	{
-		trie_node_t *next;
-		if (seq[pos+1])
-			// Intermediate node
-			next = new_node_arr (0, 0xff);
-		else
-			// Final key node
-			next = node;
-
-		if (!next)
-			return 0;
-
-		switch (p->type)
-		{
-		case TYPE_ARRAY:
-		{
-			trie_node_array_t *nar = (trie_node_array_t *) p;
-			if (b < nar->min || b > nar->max)
-			{
-				fprintf (stderr, "fatal: trie insert at 0x%02x is outside of"
-					" extent bounds (0x%02x..0x%02x)\n",
-					b, nar->min, nar->max);
-				abort ();
-			}
-			nar->arr[b - nar->min] = next;
-			p = next;
-			break;
-		}
-		case TYPE_KEY:
-		case TYPE_MOUSE:
-			fprintf (stderr, "fatal: tried to insert child node in TYPE_KEY\n");
-			abort ();
-		}
+		uint16_t child = trie->children[n->index + c - n->min];
+		if (!child)
+			continue;
 
-		pos++;
+		seq[depth] = c;
+		if (!add_node_sequences (tk, trie, child, seq, depth + 1, b))
+			described = false;
+		dead_end = false;
 	}
-	return 1;
+
+	// These would make peekkey() want more input, which we can't express
+	return described && (!dead_end || !depth);
+}
+
+static bool
+add_sequences (termo_t *tk, void *info, automaton_builder_t *b)
+{
+	termo_ti_t *ti = info;
+	unsigned char seq[TI_MAX_SEQUENCE];
+	return add_node_sequences (tk, &ti->db->trie, 0, seq, 0, b);
 }
 
 termo_driver_t termo_driver_ti =
 {
-	.name         = "terminfo",
-	.new_driver   = new_driver,
-	.free_driver  = free_driver,
-	.start_driver = start_driver,
-	.stop_driver  = stop_driver,
-	.peekkey      = peekkey,
+	.name            = "terminfo",
+	.new_driver      = new_driver,
+	.free_driver     = free_driver,
+	.start_driver    = start_driver,
+	.stop_driver     = stop_driver,
+	.peekkey         = peekkey,
+	.starts_sequence = starts_sequence,
+	.add_sequences   = add_sequences,
 };
@@ -0,0 +1,151 @@
+// Compiles terminfo entries into the tables built into the terminfo driver.
+// The driver is included directly, so that its internals can be reused.
+#define TERMO_GEN_TABLES
+#include "driver-ti.c"
+
+#include <stdlib.h>
+
+static void
+print_string (FILE *fp, const char *s)
+{
+	if (!s)
+	{
+		fprintf (fp, "NULL");
+		return;
+	}
+
+	fputc ('"', fp);
+	for (; *s; s++)
+	{
+		unsigned char c = *s;
+		// Also avoid producing trigraphs
+		if (c < 0x20 || c >= 0x7f || c == '"' || c == '\\'
+		 || (c == '?' && s[1] == '?'))
+			fprintf (fp, "\\%03o", c);
+		else
+			fputc (c, fp);
+	}
+	fputc ('"', fp);
+}
+
+static void
+print_identifier (FILE *fp, const char *prefix, const char *term)
+{
+	fprintf (fp, "%s", prefix);
+	for (; *term; term++)
+		fputc (isalnum ((unsigned char) *term) ? *term : '_', fp);
+}
+
+static void
+print_tables (FILE *fp, const ti_db_t *db)
+{
+	const trie_t *trie = &db->trie;
+	fprintf (fp, "// %s\n\n", db->term);
+
+	print_identifier (fp, "static const keyinfo_t builtin_keys_", db->term);
+	fprintf (fp, "[] =\n{\n");
+	for (size_t i = 0; i < trie->nkeys; i++)
+	{
+		const keyinfo_t *k = &trie->keys[i];
+		fprintf (fp, "\t{ %d, %d, %d, %d },\n",
+			k->type, k->sym, k->modifier_mask, k->modifier_set);
+	}
+	if (!trie->nkeys)
+		fprintf (fp, "\t{ 0, 0, 0, 0 },\n");
+	fprintf (fp, "};\n\n");
+
+	print_identifier (fp, "static const trie_node_t builtin_nodes_", db->term);
+	fprintf (fp, "[] =\n{\n");
+	for (size_t i = 0; i < trie->nnodes; i++)
+	{
+		const trie_node_t *n = &trie->nodes[i];
+		fprintf (fp, "\t{ %d, 0x%02x, 0x%02x, %u },\n",
+			n->type, n->min, n->max, n->index);
+	}
+	fprintf (fp, "};\n\n");
+
+	print_identifier (fp, "static const uint16_t builtin_children_", db->term);
+	fprintf (fp, "[] =\n{");
+	for (size_t i = 0; i < trie->nchildren; i++)
+		fprintf (fp, "%s%u,", i % 12 ? " " : "\n\t", trie->children[i]);
+	if (!trie->nchildren)
+		fprintf (fp, "\n\t0,");
+	fprintf (fp, "\n};\n\n");
+}
+
+static void
+print_entry (FILE *fp, const ti_db_t *db)
+{
+	const trie_t *trie = &db->trie;
+	fprintf (fp, "\t{\n\t\t");
+	print_string (fp, db->term);
+	fprintf (fp, ", %s,\n", db->have_mouse ? "true" : "false");
+
+	print_identifier (fp, "\t\tbuiltin_keys_", db->term);
+	fprintf (fp, ", %zu,\n", trie->nkeys);
+	print_identifier (fp, "\t\tbuiltin_nodes_", db->term);
+	fprintf (fp, ", %zu,\n", trie->nnodes);
+	print_identifier (fp, "\t\tbuiltin_children_", db->term);
+	fprintf (fp, ", %zu,\n\t\t", trie->nchildren);
+
+	print_string (fp, db->start_string);
+	fprintf (fp, ",\n\t\t");
+	print_string (fp, db->stop_string);
+	fprintf (fp, ",\n\t\t");
+	print_string (fp, db->set_mouse_string);
+	fprintf (fp, ",\n\t},\n");
+}
+
+int
+main (int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		fprintf (stderr, "Usage: %s OUTPUT TERM...\n", argv[0]);
+		return 1;
+	}
+
+	int nterms = argc - 2;
+	ti_db_t *dbs = calloc (nterms, sizeof *dbs);
+	if (!dbs)
+		return 1;
+
+	for (int i = 0; i < nterms; i++)
+	{
+		dbs[i].term = argv[i + 2];
+		if (!load_terminfo (&dbs[i], dbs[i].term))
+		{
+			fprintf (stderr, "%s: cannot load terminfo entry\n", dbs[i].term);
+			return 1;
+		}
+	}
+
+	FILE *fp = fopen (argv[1], "w");
+	if (!fp)
+	{
+		perror (argv[1]);
+		return 1;
+	}
+
+	fprintf (fp, "// Generated by termo-gen-tables, do not edit\n\n");
+
+	// The enumerations are stored as numbers, make sure they still match
+	fprintf (fp, "typedef char builtin_ti_check[TERMO_N_SYMS == %d\n"
+		"\t&& TERMO_TYPE_FUNCTION == %d && TERMO_TYPE_KEYSYM == %d ? 1 : -1];\n\n",
+		TERMO_N_SYMS, TERMO_TYPE_FUNCTION, TERMO_TYPE_KEYSYM);
+
+	for (int i = 0; i < nterms; i++)
+		print_tables (fp, &dbs[i]);
+
+	fprintf (fp, "static const builtin_ti_t builtin_ti[] =\n{\n");
+	for (int i = 0; i < nterms; i++)
+		print_entry (fp, &dbs[i]);
+	fprintf (fp, "\t{ NULL },\n};\n");
+
+	if (fclose (fp))
+	{
+		perror (argv[1]);
+		return 1;
+	}
+	return 0;
+}
@@ -8,6 +8,8 @@
 #include <stdbool.h>
 #include <iconv.h>
 
+typedef struct automaton_builder automaton_builder_t;
+
 typedef struct termo_driver termo_driver_t;
 struct termo_driver
 {
@@ -18,6 +20,11 @@ struct termo_driver
 	int (*stop_driver) (termo_t *tk, void *info);
 	termo_result_t (*peekkey) (termo_t *tk,
 		void *info, termo_key_t *key, int force, size_t *nbytes);
+	// Whether the driver might be interested in a key starting with the byte
+	bool (*starts_sequence) (void *info, unsigned char byte);
+	// Describes fixed sequences to the automaton through add_sequence(),
+	// returns whether peekkey() wouldn't recognise anything else
+	bool (*add_sequences) (termo_t *tk, void *info, automaton_builder_t *b);
 };
 
 typedef struct keyinfo keyinfo_t;
@@ -29,6 +36,36 @@ struct keyinfo
 	int modifier_set;
 };
 
+// What reaching a state of the unified decoding automaton means
+typedef enum
+{
+	AUTOMATON_PREFIX, // The sequence may continue
+	AUTOMATON_KEY,    // A complete key, as described by a keyinfo
+	AUTOMATON_MOUSE   // Mouse data follows, see peekkey_mouse()
+}
+automaton_action_t;
+
+typedef struct automaton_state automaton_state_t;
+struct automaton_state
+{
+	uint8_t action;         // automaton_action_t
+	unsigned char min, max; // INCLUSIVE extent of bytes with transitions
+	uint8_t partial;        // Drivers with longer sequences passing through
+	uint16_t index;         // Into next for prefixes, into keys for keys
+};
+
+// The sequences of all drivers merged into a single byte-driven automaton,
+// so that most keys are decoded in one pass rather than by each driver
+// in turn.  State 0 is the root, which isn't anyone's successor.
+typedef struct automaton automaton_t;
+struct automaton
+{
+	automaton_state_t *states;
+	uint16_t *next;         // Successor states for the extents of prefixes
+	keyinfo_t *keys;
+	uint8_t complete;       // Drivers that have described all their sequences
+};
+
 typedef struct termo_driver_node termo_driver_node_t;
 struct termo_driver_node
 {
@@ -37,42 +74,127 @@ struct termo_driver_node
 	termo_driver_node_t *next;
 };
 
+enum conv_type
+{
+	CONV_ICONV, // Generic conversion through iconv()
+	CONV_UTF8,  // Native UTF-8 conversion
+	CONV_SBCS   // Single-byte encodings through precomputed tables
+};
+
+typedef struct sbcs_mapping sbcs_mapping_t;
+struct sbcs_mapping
+{
+	uint32_t codepoint;
+	unsigned char byte;
+};
+
+typedef struct sbcs_table sbcs_table_t;
+struct sbcs_table
+{
+	uint32_t to_codepoint[256]; // Byte to codepoint
+	sbcs_mapping_t from_codepoint[256]; // Sorted by codepoint
+	size_t from_codepoint_len;
+};
+
 enum peekey_flags
 {
 	PEEKKEY_FORCE        = 1 << 0,
 	PEEKKEY_ALT_PREFIXED = 1 << 1
 };
 
+// How many delays the adaptive waittime is computed from
+#define WAITTIME_SAMPLES 32
+// Milliseconds added to what the adaptive waittime has been computed to be
+#define WAITTIME_MARGIN 10
+
 struct termo
 {
 	int fd;
 	int flags;
 	int canonflags;
 
+	// The buffer is a ring with a power-of-two size of buffmask + 1 bytes,
+	// so that data never has to be moved around within it
 	unsigned char *buffer;
-	size_t buffstart; // First offset in buffer
+	size_t buffstart; // First offset in buffer, taken modulo the ring size
 	size_t buffcount; // Number of entires valid in buffer
-	size_t buffsize; // Total malloc'ed size
+	size_t buffsize; // Maximum value of buffcount
+	size_t buffmask; // Size of the ring minus one
+
+	// When buffsize_max is larger than buffsize_base, the buffer grows
+	// as needed up to that size, and shrinks back once it is idle again
+	size_t buffsize_base; // Buffer size as requested by the user
+	size_t buffsize_max; // Ceiling for the adaptive mode
 
 	// Position beyond buffstart at which peekkey() should next start.
 	// Normally 0, but see also termo_interpret_csi().
 	size_t hightide;
+	// The most recent unknown CSI, until peekkey() gets called again
+	termo_csi_info_t csi_info;
+	bool csi_info_valid;
+	// Total number of bytes eaten so far.  Together with buffstart,
+	// it lets drivers recognise a sequence they've already seen part of.
+	size_t eaten;
+	// The value of eaten + buffcount right after the last read
+	size_t read_boundary;
+
+	// Bytes at which a key might start that isn't plain text
+	bool sequence_start[256];
+	// Whether all such bytes are among C0, DEL and C1, see scan_plain()
+	bool can_scan_plain;
+	// How many bytes from buffstart are known not to contain sequence starts
+	size_t plain_run;
+
+	// termo_getkey() decodes incomplete input in force mode ahead of time,
+	// and termo_getkey_force() can take that over unless more has arrived
+	struct
+	{
+		bool valid;
+		size_t eaten; // Where the input has been decoded
+		size_t buffcount; // How much of it there was
+		termo_key_t key;
+		size_t nbytes;
+		size_t hightide;
+	}
+	forced;
+	// Finds the first byte among C0, DEL and C1
+	size_t (*scan_candidates) (const unsigned char *p, size_t len);
 
 	struct termios restore_termios;
 	bool restore_termios_valid;
+	struct termios started_termios; // As set by termo_start()
+	// VTIME currently set on the terminal, or 0 with VMIN at 1 as usual.
+	// It is only set while an incomplete sequence is waiting in the buffer.
+	int vtime;
 
-	int waittime; // In milliseconds
+	int waittime; // In milliseconds, as currently in effect
+	int waittime_base; // Waittime as requested by the user
+	int waittime_max; // Ceiling for the adaptive mode, 0 if disabled
+
+	// In the adaptive mode, the waittime follows how long it has taken for
+	// sequences to arrive in full, all times being in microseconds
+	int64_t last_input; // When the last input has arrived
+	int64_t partial_since; // When the pending sequence has begun, or 0
+	size_t partial_eaten; // Where the pending sequence is in the input
+	int64_t probe_sent; // When a position request has been sent, or 0
+	uint32_t gaps[WAITTIME_SAMPLES]; // The most recent delays observed
+	size_t ngaps; // How many of them are valid
+	size_t gaps_next; // Which one gets replaced next
 
 	bool is_closed; // We've received EOF
+	bool in_paste; // Between bracketed paste start and end markers
 	bool is_started;
 
 	int nkeynames;
 	const char **keynames;
 
 	keyinfo_t c0[32]; // There are 32 C0 codes
+	enum conv_type conv; // How to convert between the encoding and Unicode
 	iconv_t to_utf32_conv;
 	iconv_t from_utf32_conv;
+	sbcs_table_t *sbcs; // Only used for CONV_SBCS
 	termo_driver_node_t *drivers;
+	automaton_t *automaton; // Only built with TERMO_FLAG_AUTOMATON
 
 	// Now some "protected" methods for the driver to call but which we don't
 	// want exported as real symbols in the library
@@ -84,6 +206,9 @@ struct termo
 			termo_key_t *key, int flags, size_t *nbytes);
 		termo_result_t (*peekkey_mouse) (termo_t *tk,
 			termo_key_t *key, size_t *nbytes);
+		void (*add_sequence) (automaton_builder_t *b,
+			const unsigned char *seq, size_t len,
+			automaton_action_t action, const keyinfo_t *key);
 	}
 	method;
 
@@ -94,6 +219,11 @@ struct termo
 	// Mouse tracking mode
 	termo_mouse_tracking_t mouse_tracking;
 
+	// Requested kitty keyboard protocol enhancements
+	int keyboard_flags;
+	// What the terminal has replied to our query, or -1 if nothing yet
+	int reported_keyboard_flags;
+
 	// The mouse unfortunately directly depends on the terminfo driver to let
 	// it handle changes in the mouse protocol.
 
@@ -103,10 +233,31 @@ struct termo
 	{
 		bool (*set_mouse_proto) (void *, termo_mouse_proto_t, bool);
 		bool (*set_mouse_tracking_mode) (void *, termo_mouse_tracking_t, bool);
+		bool (*set_keyboard_flags) (void *, int, bool);
+		bool (*set_bracketed_paste) (void *, bool);
 	}
 	ti_method;
 };
 
+#define CHARAT(i) (tk->buffer[(tk->buffstart + (i)) & tk->buffmask])
+
+// Hides the first `count' bytes of the buffer from decoders for a while,
+// so that they see the rest of it as if it were the whole input
+static inline void
+hide_bytes (termo_t *tk, size_t count)
+{
+	tk->buffstart = (tk->buffstart + count) & tk->buffmask;
+	tk->buffcount -= count;
+}
+
+// Undoes hide_bytes()
+static inline void
+unhide_bytes (termo_t *tk, size_t count)
+{
+	tk->buffstart = (tk->buffstart - count) & tk->buffmask;
+	tk->buffcount += count;
+}
+
 static inline void
 termo_key_get_linecol (const termo_key_t *key, int *line, int *col)
 {
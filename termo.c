@@ -1,10 +1,20 @@
+// We want clock_gettime()
+#define _XOPEN_SOURCE 600
+
 #include "termo.h"
 #include "termo-internal.h"
 
 #include <ctype.h>
 #include <errno.h>
 #include <poll.h>
+#include <time.h>
 #include <unistd.h>
+#include <sys/uio.h>
+#include <sys/ioctl.h>
+
+#if defined __GNUC__ && defined __SSE2__
+#include <immintrin.h>
+#endif
 #include <string.h>
 #include <strings.h>
 #include <langinfo.h>
@@ -40,6 +50,22 @@ static termo_result_t peekkey_simple (termo_t *tk,
 	termo_key_t *key, int flags, size_t *nbytes);
 static termo_result_t peekkey_mouse (termo_t *tk,
 	termo_key_t *key, size_t *nbytes);
+static termo_result_t peekkey_paste (termo_t *tk,
+	termo_key_t *key, int flags, size_t *nbytes);
+static void add_sequence (automaton_builder_t *b,
+	const unsigned char *seq, size_t len,
+	automaton_action_t action, const keyinfo_t *key);
+
+static automaton_t *build_automaton (termo_t *tk);
+
+// peekkey_simple() has found an Escape prefixing another key,
+// which only ever gets as far as peekkey()
+#define TERMO_RES_ALT_PREFIX ((termo_result_t) (TERMO_RES_ERROR + 1))
+
+static sbcs_table_t *build_sbcs_table (termo_t *tk);
+static bool is_scan_candidate (unsigned char b);
+static size_t (*select_scan_candidates (void))
+	(const unsigned char *, size_t);
 
 static termo_sym_t register_c0 (termo_t *tk, termo_sym_t sym,
 	unsigned char ctrl, const char *name);
@@ -116,8 +142,6 @@ keynames[] =
 	{ 0,                    NULL       },
 };
 
-#define CHARAT(i) (tk->buffer[tk->buffstart + (i)])
-
 #ifdef DEBUG
 // Some internal deubgging functions
 
@@ -159,6 +183,19 @@ print_key (termo_t *tk, termo_key_t *key)
 	case TERMO_TYPE_FOCUS:
 		fprintf (stderr, "%s\n", key->code.focused ? "Focused" : "Defocused");
 		break;
+	case TERMO_TYPE_TEXT:
+		fprintf (stderr, "Text len=%d count=%d\n",
+			key->code.text.len, key->code.text.count);
+		break;
+	case TERMO_TYPE_PASTE_BEGIN:
+		fprintf (stderr, "Paste begin\n");
+		break;
+	case TERMO_TYPE_PASTE_DATA:
+		fprintf (stderr, "Paste len=%d\n", key->code.paste.len);
+		break;
+	case TERMO_TYPE_PASTE_END:
+		fprintf (stderr, "Paste end\n");
+		break;
 	case TERMO_TYPE_POSITION:
 	{
 		int line, col;
@@ -296,13 +333,37 @@ termo_alloc (void)
 	tk->buffstart = 0;
 	tk->buffcount = 0;
 	tk->buffsize  = 256; // bytes
+	tk->buffmask  = 0;
+
+	tk->buffsize_base = tk->buffsize;
+	tk->buffsize_max  = 0; // The adaptive mode is disabled
 	tk->hightide  = 0;
+	tk->eaten     = 0;
+	tk->read_boundary = 0;
+
+	tk->csi_info_valid = false;
+
+	tk->can_scan_plain  = false;
+	tk->plain_run       = 0;
+	tk->forced.valid    = false;
+	tk->scan_candidates = select_scan_candidates ();
 
 	tk->restore_termios_valid = false;
+	tk->vtime = 0;
+
+	tk->waittime      = 50; // msec
+	tk->waittime_base = tk->waittime;
+	tk->waittime_max  = 0; // The adaptive mode is disabled
 
-	tk->waittime = 50; // msec
+	tk->last_input    = 0;
+	tk->partial_since = 0;
+	tk->partial_eaten = 0;
+	tk->probe_sent    = 0;
+	tk->ngaps         = 0;
+	tk->gaps_next     = 0;
 
 	tk->is_closed  = false;
+	tk->in_paste   = false;
 	tk->is_started = false;
 
 	tk->nkeynames = 64;
@@ -311,22 +372,44 @@ termo_alloc (void)
 	for (int i = 0; i < 32; i++)
 		tk->c0[i].sym = TERMO_SYM_NONE;
 
+	tk->conv = CONV_ICONV;
+	tk->to_utf32_conv = (iconv_t) -1;
+	tk->from_utf32_conv = (iconv_t) -1;
+	tk->sbcs = NULL;
+
 	tk->drivers = NULL;
+	tk->automaton = NULL;
 
 	tk->method.emit_codepoint = &emit_codepoint;
 	tk->method.peekkey_simple = &peekkey_simple;
 	tk->method.peekkey_mouse  = &peekkey_mouse;
+	tk->method.add_sequence   = &add_sequence;
 
 	tk->mouse_proto = TERMO_MOUSE_PROTO_NONE;
 	tk->mouse_tracking = TERMO_MOUSE_TRACKING_CLICK;
 	tk->guessed_mouse_proto = TERMO_MOUSE_PROTO_NONE;
 
+	tk->keyboard_flags = 0;
+	tk->reported_keyboard_flags = -1;
+
 	tk->ti_data = NULL;
 	tk->ti_method.set_mouse_proto = NULL;
 	tk->ti_method.set_mouse_tracking_mode = NULL;
+	tk->ti_method.set_keyboard_flags = NULL;
+	tk->ti_method.set_bracketed_paste = NULL;
 	return tk;
 }
 
+// Rounds the buffer size up to a power of two, as needed by the ring
+static size_t
+ring_size (size_t size)
+{
+	size_t ring = 1;
+	while (ring < size)
+		ring <<= 1;
+	return ring;
+}
+
 static int
 termo_init (termo_t *tk, const char *term, const char *encoding)
 {
@@ -338,14 +421,31 @@ termo_init (termo_t *tk, const char *term, const char *encoding)
 	const char *utf32 = (*(uint8_t *) &endianity == 0x01)
 		? "UTF-32BE" : "UTF-32LE";
 
-	if ((tk->to_utf32_conv = iconv_open (utf32, encoding)) == (iconv_t) -1)
+	// The overwhelmingly common case doesn't need iconv() at all
+	tk->conv = CONV_ICONV;
+	if (!strcasecmp (encoding, "UTF-8") || !strcasecmp (encoding, "UTF8"))
+		tk->conv = CONV_UTF8;
+	else if ((tk->to_utf32_conv =
+		iconv_open (utf32, encoding)) == (iconv_t) -1)
 		return 0;
-	if ((tk->from_utf32_conv = iconv_open (encoding, utf32)) == (iconv_t) -1)
+	else if ((tk->from_utf32_conv =
+		iconv_open (encoding, utf32)) == (iconv_t) -1)
 		goto abort_free_to_utf32;
+	else if ((tk->sbcs = build_sbcs_table (tk)))
+	{
+		// The tables make iconv() completely unnecessary
+		tk->conv = CONV_SBCS;
+		iconv_close (tk->to_utf32_conv);
+		tk->to_utf32_conv = (iconv_t) -1;
+		iconv_close (tk->from_utf32_conv);
+		tk->from_utf32_conv = (iconv_t) -1;
+	}
 
-	tk->buffer = malloc (tk->buffsize);
+	size_t ring = ring_size (tk->buffsize);
+	tk->buffer = malloc (ring);
 	if (!tk->buffer)
 		goto abort_free_from_utf32;
+	tk->buffmask = ring - 1;
 
 	tk->keynames = malloc (sizeof tk->keynames[0] * tk->nkeynames);
 	if (!tk->keynames)
@@ -395,6 +495,25 @@ termo_init (termo_t *tk, const char *term, const char *encoding)
 		errno = ENOENT;
 		goto abort_free_keynames;
 	}
+
+	// Find out which bytes are interesting to anyone but peekkey_simple()
+	tk->can_scan_plain = true;
+	for (i = 0; i < 256; i++)
+	{
+		bool claimed = i == 0x1b;
+		for (termo_driver_node_t *p = tk->drivers; p; p = p->next)
+			if (!p->driver->starts_sequence
+			 || p->driver->starts_sequence (p->info, i))
+				claimed = true;
+
+		tk->sequence_start[i] = claimed;
+		if (claimed && !is_scan_candidate (i))
+			tk->can_scan_plain = false;
+	}
+
+	if ((tk->flags & TERMO_FLAG_AUTOMATON)
+	 && !(tk->automaton = build_automaton (tk)))
+		goto abort_free_drivers;
 	return 1;
 
 abort_free_drivers:
@@ -411,9 +530,12 @@ abort_free_keynames:
 abort_free_buffer:
 	free (tk->buffer);
 abort_free_from_utf32:
-	iconv_close (tk->from_utf32_conv);
+	free (tk->sbcs);
+	if (tk->from_utf32_conv != (iconv_t) -1)
+		iconv_close (tk->from_utf32_conv);
 abort_free_to_utf32:
-	iconv_close (tk->to_utf32_conv);
+	if (tk->to_utf32_conv != (iconv_t) -1)
+		iconv_close (tk->to_utf32_conv);
 	return 0;
 }
 
@@ -462,11 +584,16 @@ termo_free (termo_t *tk)
 	free (tk->buffer);   tk->buffer   = NULL;
 	free (tk->keynames); tk->keynames = NULL;
 
-	iconv_close (tk->to_utf32_conv);
+	free (tk->sbcs); tk->sbcs = NULL;
+	if (tk->to_utf32_conv != (iconv_t) -1)
+		iconv_close (tk->to_utf32_conv);
 	tk->to_utf32_conv = (iconv_t) -1;
-	iconv_close (tk->from_utf32_conv);
+	if (tk->from_utf32_conv != (iconv_t) -1)
+		iconv_close (tk->from_utf32_conv);
 	tk->from_utf32_conv = (iconv_t) -1;
 
+	free (tk->automaton); tk->automaton = NULL;
+
 	termo_driver_node_t *p, *next;
 	for (p = tk->drivers; p; p = next)
 	{
@@ -486,6 +613,34 @@ termo_destroy (termo_t *tk)
 	termo_free (tk);
 }
 
+// With TERMO_FLAG_VTIME, the kernel is to wait for input for about as long
+// as we would, although only in steps of tenths of a second
+static int
+desired_vtime (termo_t *tk)
+{
+	if (!(tk->flags & TERMO_FLAG_VTIME) || !tk->restore_termios_valid)
+		return 0;
+
+	int vtime = (tk->waittime + 99) / 100;
+	if (vtime < 1)
+		return 1;
+	return vtime > 255 ? 255 : vtime;
+}
+
+// Switches between VMIN at 1 and VMIN at 0 with the given VTIME
+static void
+set_vtime (termo_t *tk, int vtime)
+{
+	if (vtime == tk->vtime || !tk->restore_termios_valid)
+		return;
+
+	struct termios termios = tk->started_termios;
+	termios.c_cc[VMIN]  = !vtime;
+	termios.c_cc[VTIME] = vtime;
+	if (!tcsetattr (tk->fd, TCSANOW, &termios))
+		tk->vtime = vtime;
+}
+
 int
 termo_start (termo_t *tk)
 {
@@ -502,7 +657,8 @@ termo_start (termo_t *tk)
 
 			termios.c_iflag &= ~(IXON|INLCR|ICRNL);
 			termios.c_lflag &= ~(ICANON|ECHO);
-			termios.c_cc[VMIN]  = 1;
+
+			termios.c_cc[VMIN] = 1;
 			termios.c_cc[VTIME] = 0;
 
 			if (tk->flags & TERMO_FLAG_CTRLC)
@@ -523,6 +679,7 @@ termo_start (termo_t *tk)
 			fprintf (stderr, "Setting termios(3) flags\n");
 #endif
 			tcsetattr (tk->fd, TCSANOW, &termios);
+			tk->started_termios = termios;
 		}
 	}
 
@@ -553,6 +710,8 @@ termo_stop (termo_t *tk)
 
 	if (tk->restore_termios_valid)
 		tcsetattr (tk->fd, TCSANOW, &tk->restore_termios);
+	tk->vtime = 0;
+	tk->forced.valid = false;
 
 	tk->is_started = false;
 	return 1;
@@ -579,17 +738,113 @@ termo_get_flags (termo_t *tk)
 void
 termo_set_flags (termo_t *tk, int newflags)
 {
+	int oldflags = tk->flags;
 	tk->flags = newflags;
+	tk->forced.valid = false;
+
+	// Call the TI driver to keep the terminal in sync, so that stopping
+	// the instance later undoes exactly what is in effect
+	if (((oldflags ^ newflags) & TERMO_FLAG_PASTE)
+	 && tk->is_started && tk->ti_method.set_bracketed_paste)
+		(void) tk->ti_method.set_bracketed_paste (tk->ti_data,
+			newflags & TERMO_FLAG_PASTE);
+
 	if (tk->flags & TERMO_FLAG_SPACESYMBOL)
 		tk->canonflags |= TERMO_CANON_SPACESYMBOL;
 	else
 		tk->canonflags &= ~TERMO_CANON_SPACESYMBOL;
+
+	// Until termo_init() has loaded the drivers, there's nothing to build.
+	// Should this fail, we simply keep using the driver chain.
+	if ((tk->flags & TERMO_FLAG_AUTOMATON) && tk->drivers && !tk->automaton)
+		tk->automaton = build_automaton (tk);
+}
+
+static int64_t
+monotonic_usec (void)
+{
+	struct timespec ts;
+	if (clock_gettime (CLOCK_MONOTONIC, &ts))
+		return 0;
+	return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int
+compare_gaps (const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+	return (x > y) - (x < y);
+}
+
+// In the adaptive mode, wait long enough for nearly all of the sequences
+// we've seen so far to have arrived in full, with some margin on top
+static void
+adapt_waittime (termo_t *tk)
+{
+	if (!tk->waittime_max || !tk->ngaps)
+		return;
+
+	uint32_t sorted[WAITTIME_SAMPLES];
+	memcpy (sorted, tk->gaps, tk->ngaps * sizeof *sorted);
+	qsort (sorted, tk->ngaps, sizeof *sorted, compare_gaps);
+
+	// The 95th percentile, using the nearest rank method
+	uint32_t p95 = sorted[(tk->ngaps * 95 + 99) / 100 - 1];
+	int64_t msec = (p95 + 999) / 1000 + WAITTIME_MARGIN;
+	tk->waittime = msec < tk->waittime_max ? msec : tk->waittime_max;
+}
+
+static void
+add_gap (termo_t *tk, int64_t usec)
+{
+	if (usec <= 0)
+		return;
+	if (usec > UINT32_MAX)
+		usec = UINT32_MAX;
+
+	tk->gaps[tk->gaps_next] = usec;
+	tk->gaps_next = (tk->gaps_next + 1) % WAITTIME_SAMPLES;
+	if (tk->ngaps < WAITTIME_SAMPLES)
+		tk->ngaps++;
+	adapt_waittime (tk);
+}
+
+// Notes how long it has taken for incomplete sequences to be finished,
+// to be called with the result of peekkey() before the key is eaten
+static void
+observe_timing (termo_t *tk, termo_result_t ret, const termo_key_t *key)
+{
+	if (!tk->waittime_max)
+		return;
+
+	if (ret == TERMO_RES_AGAIN)
+	{
+		if (!tk->partial_since || tk->partial_eaten != tk->eaten)
+		{
+			tk->partial_since = tk->last_input;
+			tk->partial_eaten = tk->eaten;
+		}
+		return;
+	}
+	if (ret != TERMO_RES_KEY)
+		return;
+
+	if (tk->partial_since && tk->partial_eaten == tk->eaten)
+		add_gap (tk, tk->last_input - tk->partial_since);
+	tk->partial_since = 0;
+
+	if (tk->probe_sent && key->type == TERMO_TYPE_POSITION)
+	{
+		add_gap (tk, tk->last_input - tk->probe_sent);
+		tk->probe_sent = 0;
+	}
 }
 
 void
 termo_set_waittime (termo_t *tk, int msec)
 {
-	tk->waittime = msec;
+	tk->waittime = tk->waittime_base = msec;
+	adapt_waittime (tk);
 }
 
 int
@@ -598,6 +853,63 @@ termo_get_waittime (termo_t *tk)
 	return tk->waittime;
 }
 
+int
+termo_get_waittime_max (termo_t *tk)
+{
+	return tk->waittime_max;
+}
+
+void
+termo_set_waittime_max (termo_t *tk, int msec)
+{
+	tk->waittime_max = msec > 0 ? msec : 0;
+	if (!tk->waittime_max)
+	{
+		tk->waittime = tk->waittime_base;
+		tk->partial_since = tk->probe_sent = 0;
+	}
+	else
+		adapt_waittime (tk);
+}
+
+// Asks the terminal where the cursor is, so that the time it takes to respond
+// can be accounted for in the adaptive mode.  The report is delivered
+// as a TERMO_TYPE_POSITION key.  The DEC variant of the request is used,
+// as a plain CSI R cannot be told apart from <F3>.
+int
+termo_probe_waittime (termo_t *tk)
+{
+	if (tk->fd == -1)
+	{
+		errno = EBADF;
+		return 0;
+	}
+	if (!tk->waittime_max)
+	{
+		errno = EINVAL;
+		return 0;
+	}
+
+	static const char request[] = "\x1b[?6n";
+	const char *p = request;
+	size_t len = sizeof request - 1;
+	while (len)
+	{
+		ssize_t written = write (tk->fd, p, len);
+		if (written == -1)
+		{
+			if (errno == EINTR)
+				continue;
+			return 0;
+		}
+		p += written;
+		len -= written;
+	}
+
+	tk->probe_sent = monotonic_usec ();
+	return 1;
+}
+
 int
 termo_get_canonflags (termo_t *tk)
 {
@@ -608,6 +920,7 @@ void
 termo_set_canonflags (termo_t *tk, int flags)
 {
 	tk->canonflags = flags;
+	tk->forced.valid = false;
 	if (tk->canonflags & TERMO_CANON_SPACESYMBOL)
 		tk->flags |= TERMO_FLAG_SPACESYMBOL;
 	else
@@ -620,18 +933,90 @@ termo_get_buffer_size (termo_t *tk)
 	return tk->buffsize;
 }
 
-int
-termo_set_buffer_size (termo_t *tk, size_t size)
+static int
+resize_buffer (termo_t *tk, size_t size)
 {
-	unsigned char *buffer = realloc (tk->buffer, size);
+	// Pending hightide data must survive as well
+	if (size < tk->buffcount)
+	{
+		errno = EINVAL;
+		return 0;
+	}
+
+	size_t ring = ring_size (size);
+	unsigned char *buffer = malloc (ring);
 	if (!buffer)
 		return 0;
 
+	// Unwrap the contents, so that they start at the beginning again
+	size_t head = tk->buffmask + 1 - tk->buffstart;
+	if (head >= tk->buffcount)
+		memcpy (buffer, tk->buffer + tk->buffstart, tk->buffcount);
+	else
+	{
+		memcpy (buffer, tk->buffer + tk->buffstart, head);
+		memcpy (buffer + head, tk->buffer, tk->buffcount - head);
+	}
+
+	free (tk->buffer);
 	tk->buffer = buffer;
+	tk->buffstart = 0;
 	tk->buffsize = size;
+	tk->buffmask = ring - 1;
+	return 1;
+}
+
+int
+termo_set_buffer_size (termo_t *tk, size_t size)
+{
+	if (!resize_buffer (tk, size))
+		return 0;
+
+	tk->buffsize_base = size;
 	return 1;
 }
 
+size_t
+termo_get_buffer_max_size (termo_t *tk)
+{
+	return tk->buffsize_max;
+}
+
+void
+termo_set_buffer_max_size (termo_t *tk, size_t size)
+{
+	tk->buffsize_max = size;
+}
+
+// In the adaptive mode, try to make room for `needed' bytes in total
+static void
+grow_buffer (termo_t *tk, size_t needed)
+{
+	if (needed <= tk->buffsize || tk->buffsize >= tk->buffsize_max)
+		return;
+
+	size_t size = tk->buffsize ? tk->buffsize : 1;
+	while (size < needed && size < tk->buffsize_max)
+		size *= 2;
+	if (size > tk->buffsize_max)
+		size = tk->buffsize_max;
+
+	// Failing to grow isn't fatal, we'll just read less at once
+	(void) resize_buffer (tk, size);
+}
+
+// Figure out how many bytes are waiting to be read, if possible
+static size_t
+pending_bytes (termo_t *tk)
+{
+#ifdef FIONREAD
+	int pending = 0;
+	if (ioctl (tk->fd, FIONREAD, &pending) == 0 && pending > 0)
+		return pending;
+#endif
+	return 0;
+}
+
 size_t
 termo_get_buffer_remaining (termo_t *tk)
 {
@@ -657,6 +1042,8 @@ termo_set_mouse_proto (termo_t *tk, termo_mouse_proto_t proto)
 {
 	termo_mouse_proto_t old_proto = tk->mouse_proto;
 	tk->mouse_proto = proto;
+	// Mouse events are decoded according to the protocol
+	tk->forced.valid = false;
 
 	// Call the TI driver to apply the change if needed
 	if (proto == old_proto
@@ -695,9 +1082,39 @@ termo_set_mouse_tracking_mode (termo_t *tk, termo_mouse_tracking_t mode)
 		&& tk->ti_method.set_mouse_tracking_mode (tk->ti_data, mode, true);
 }
 
+int
+termo_get_keyboard_flags (termo_t *tk)
+{
+	return tk->keyboard_flags;
+}
+
+int
+termo_set_keyboard_flags (termo_t *tk, int flags)
+{
+	int old_flags = tk->keyboard_flags;
+	tk->keyboard_flags = flags;
+
+	// Call the TI driver to apply the change if needed
+	if (flags == old_flags
+	 || !tk->is_started
+	 || !tk->ti_method.set_keyboard_flags)
+		return true;
+
+	return tk->ti_method.set_keyboard_flags (tk->ti_data, old_flags, false)
+		&& tk->ti_method.set_keyboard_flags (tk->ti_data, flags, true);
+}
+
+int
+termo_get_reported_keyboard_flags (termo_t *tk)
+{
+	return tk->reported_keyboard_flags;
+}
+
 static void
 eat_bytes (termo_t *tk, size_t count)
 {
+	tk->plain_run = count < tk->plain_run ? tk->plain_run - count : 0;
+	tk->eaten += count;
 	if (count >= tk->buffcount)
 	{
 		tk->buffstart = 0;
@@ -705,82 +1122,513 @@ eat_bytes (termo_t *tk, size_t count)
 		return;
 	}
 
-	tk->buffstart += count;
+	tk->buffstart = (tk->buffstart + count) & tk->buffmask;
 	tk->buffcount -= count;
 }
 
-#define MULTIBYTE_INVALID '?'
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-static void
-fill_multibyte (termo_t *tk, termo_key_t *key)
+// Most input is plain text that none of the drivers is interested in,
+// so we look ahead for runs of it and let those skip the driver chain.
+// The vectorised search only finds C0, DEL and C1 characters, the rest
+// is decided by looking into the sequence_start table.
+
+static inline bool
+is_scan_candidate (unsigned char b)
 {
-	size_t codepoint_len = sizeof key->code.codepoint;
-	char *codepoint_ptr = (char *) &key->code.codepoint;
-	size_t multibyte_len = sizeof key->multibyte;
-	char *multibyte_ptr = (char *) key->multibyte;
+	return (b & 0x7f) < 0x20 || b == 0x7f;
+}
 
-	size_t result = iconv (tk->from_utf32_conv,
-		&codepoint_ptr, &codepoint_len, &multibyte_ptr, &multibyte_len);
-	size_t output = sizeof key->multibyte - multibyte_len;
+static size_t
+scan_candidates_scalar (const unsigned char *p, size_t len)
+{
+	size_t i = 0;
+	while (i < len && !is_scan_candidate (p[i]))
+		i++;
+	return i;
+}
 
-	// Something broke
-	if (result == (size_t) -1 || output == 0)
+#if defined __GNUC__ && defined __SSE2__
+#define HAVE_SCAN_CANDIDATES_SSE2
+
+static size_t
+scan_candidates_sse2 (const unsigned char *p, size_t len)
+{
+	const __m128i low7 = _mm_set1_epi8 (0x7f);
+	const __m128i c0_end = _mm_set1_epi8 (0x20);
+
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
 	{
-		key->multibyte[0] = MULTIBYTE_INVALID;
-		key->multibyte[1] = 0;
-		return;
-	}
+		__m128i x = _mm_loadu_si128 ((const __m128i *) (p + i));
+		__m128i hit = _mm_or_si128
+			(_mm_cmplt_epi8 (_mm_and_si128 (x, low7), c0_end),
+			 _mm_cmpeq_epi8 (x, low7));
 
-	// Append a null character, as it wasn't part of the input
-	key->multibyte[output] = 0;
+		int mask = _mm_movemask_epi8 (hit);
+		if (mask)
+			return i + __builtin_ctz (mask);
+	}
+	return i + scan_candidates_scalar (p + i, len - i);
 }
 
-static termo_result_t
-parse_multibyte (termo_t *tk, const unsigned char *bytes, size_t len,
-	uint32_t *cp, size_t *nbytep)
+__attribute__ ((target ("avx2"))) static size_t
+scan_candidates_avx2 (const unsigned char *p, size_t len)
 {
-	size_t multibyte_len = len;
-	char *multibyte_ptr = (char *) bytes;
-	size_t codepoint_len = sizeof *cp;
-	char *codepoint_ptr = (char *) cp;
+	const __m256i low7 = _mm256_set1_epi8 (0x7f);
+	const __m256i c0_end = _mm256_set1_epi8 (0x20);
 
-	// Fingers crossed...
-	errno = 0;
-	iconv (tk->to_utf32_conv,
-		&multibyte_ptr, &multibyte_len, &codepoint_ptr, &codepoint_len);
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32)
+	{
+		__m256i x = _mm256_loadu_si256 ((const __m256i *) (p + i));
+		__m256i hit = _mm256_or_si256
+			(_mm256_cmpgt_epi8 (c0_end, _mm256_and_si256 (x, low7)),
+			 _mm256_cmpeq_epi8 (x, low7));
 
-	// Only one Unicode character could have been processed at maximum,
-	// so let's just set the number of processed bytes to the difference
-	*nbytep = len - multibyte_len;
+		unsigned mask = _mm256_movemask_epi8 (hit);
+		if (mask)
+			return i + __builtin_ctz (mask);
+	}
+	return i + scan_candidates_sse2 (p + i, len - i);
+}
+#endif
 
-	// Nothing has been converted, let's examine what happened
-	if (codepoint_ptr == (char *) cp)
+static size_t (*select_scan_candidates (void))
+	(const unsigned char *, size_t)
+{
+#ifdef HAVE_SCAN_CANDIDATES_SSE2
+	if (__builtin_cpu_supports ("avx2"))
+		return scan_candidates_avx2;
+	return scan_candidates_sse2;
+#else
+	return scan_candidates_scalar;
+#endif
+}
+
+// Returns how many bytes from the start of the buffer are such that
+// a key starting at any of them would only be handled by peekkey_simple()
+static size_t
+scan_plain (termo_t *tk)
+{
+	size_t run = 0;
+	while (run < tk->buffcount)
 	{
-		if (errno == 0)
-			// The input was probably a shift sequence
-			return TERMO_RES_AGAIN;
-		if (errno == EINVAL)
-			// Incomplete character or shift sequence
-			return TERMO_RES_AGAIN;
-		if (errno == EILSEQ)
-		{
-			// Invalid multibyte sequence in the input, let's try going
-			// byte after byte in hope we skip it completely
-			*cp = MULTIBYTE_INVALID;
-			*nbytep = 1;
-			return TERMO_RES_KEY;
-		}
+		size_t start = (tk->buffstart + run) & tk->buffmask;
+		size_t len = tk->buffmask + 1 - start;
+		if (len > tk->buffcount - run)
+			len = tk->buffcount - run;
 
-		// We can't really get E2BIG so what the fuck is going on here
-		abort ();
+		size_t i = tk->scan_candidates (tk->buffer + start, len);
+		run += i;
+		if (i == len)
+			continue;
+		if (tk->sequence_start[tk->buffer[start + i]])
+			break;
+		run++;
 	}
-	return TERMO_RES_KEY;
+	return run;
 }
 
-static void
-emit_codepoint (termo_t *tk, uint32_t codepoint, termo_key_t *key)
+// Returns `len' bytes at offset `i' within the buffer as a contiguous run,
+// copying them out to `scratch' only if they happen to wrap around the ring
+static const unsigned char *
+peek_bytes (termo_t *tk, size_t i, size_t len, unsigned char *scratch)
 {
-	if (codepoint == 0)
+	size_t start = (tk->buffstart + i) & tk->buffmask;
+	if (start + len <= tk->buffmask + 1)
+		return tk->buffer + start;
+
+	for (size_t k = 0; k < len; k++)
+		scratch[k] = CHARAT (i + k);
+	return scratch;
+}
+
+// Sets up to two segments of free space at the end of the ring,
+// returning how many of them there are
+static int
+free_segments (termo_t *tk, struct iovec iov[2])
+{
+	size_t ring = tk->buffmask + 1;
+	size_t end = (tk->buffstart + tk->buffcount) & tk->buffmask;
+	size_t avail = tk->buffsize - tk->buffcount;
+
+	iov[0].iov_base = tk->buffer + end;
+	iov[0].iov_len = ring - end;
+	if (iov[0].iov_len >= avail)
+	{
+		iov[0].iov_len = avail;
+		return 1;
+	}
+
+	iov[1].iov_base = tk->buffer;
+	iov[1].iov_len = avail - iov[0].iov_len;
+	return 2;
+}
+
+#define MULTIBYTE_INVALID '?'
+
+static inline size_t
+utf8_seqlen (uint32_t codepoint)
+{
+	if (codepoint < 0x0000080) return 1;
+	if (codepoint < 0x0000800) return 2;
+	if (codepoint < 0x0010000) return 3;
+	if (codepoint < 0x0200000) return 4;
+	if (codepoint < 0x4000000) return 5;
+	return 6;
+}
+
+// Encodes the codepoint into `buf', which must have room for 7 bytes,
+// and null-terminates it.  Returns the length of the sequence.
+static size_t
+utf8_encode (uint32_t codepoint, char *buf)
+{
+	size_t nbytes = utf8_seqlen (codepoint);
+	buf[nbytes] = 0;
+
+	// This is easier done backwards
+	for (size_t b = nbytes; b-- > 1; codepoint >>= 6)
+		buf[b] = 0x80 | (codepoint & 0x3f);
+
+	switch (nbytes)
+	{
+	case 1: buf[0] =        (codepoint & 0x7f); break;
+	case 2: buf[0] = 0xc0 | (codepoint & 0x1f); break;
+	case 3: buf[0] = 0xe0 | (codepoint & 0x0f); break;
+	case 4: buf[0] = 0xf0 | (codepoint & 0x07); break;
+	case 5: buf[0] = 0xf8 | (codepoint & 0x03); break;
+	case 6: buf[0] = 0xfc | (codepoint & 0x01); break;
+	}
+	return nbytes;
+}
+
+static void
+fill_multibyte_utf8 (termo_key_t *key)
+{
+	uint32_t codepoint = key->code.codepoint;
+
+	// Just like iconv(), refuse what can't be represented in UTF-8 legally
+	if (codepoint > 0x10ffff || (codepoint >= 0xd800 && codepoint <= 0xdfff))
+	{
+		key->multibyte[0] = MULTIBYTE_INVALID;
+		key->multibyte[1] = 0;
+		return;
+	}
+	utf8_encode (codepoint, key->multibyte);
+}
+
+static void
+fill_multibyte_iconv (termo_t *tk, termo_key_t *key)
+{
+	size_t codepoint_len = sizeof key->code.codepoint;
+	char *codepoint_ptr = (char *) &key->code.codepoint;
+	size_t multibyte_len = sizeof key->multibyte;
+	char *multibyte_ptr = (char *) key->multibyte;
+
+	size_t result = iconv (tk->from_utf32_conv,
+		&codepoint_ptr, &codepoint_len, &multibyte_ptr, &multibyte_len);
+	size_t output = sizeof key->multibyte - multibyte_len;
+
+	// Something broke
+	if (result == (size_t) -1 || output == 0)
+	{
+		key->multibyte[0] = MULTIBYTE_INVALID;
+		key->multibyte[1] = 0;
+		return;
+	}
+
+	// Append a null character, as it wasn't part of the input
+	key->multibyte[output] = 0;
+}
+
+static int
+sbcs_mapping_compare (const void *a, const void *b)
+{
+	uint32_t ca = ((const sbcs_mapping_t *) a)->codepoint;
+	uint32_t cb = ((const sbcs_mapping_t *) b)->codepoint;
+	if (ca != cb)
+		return ca < cb ? -1 : 1;
+
+	// Make the sort stable, preferring lower bytes for duplicates
+	return (int) ((const sbcs_mapping_t *) a)->byte
+		- (int) ((const sbcs_mapping_t *) b)->byte;
+}
+
+// Runs all possible bytes through iconv() to see if the encoding is
+// a stateless single-byte one, and if it is, returns translation tables
+static sbcs_table_t *
+build_sbcs_table (termo_t *tk)
+{
+	sbcs_table_t *table = malloc (sizeof *table);
+	if (!table)
+		return NULL;
+
+	table->from_codepoint_len = 0;
+	for (int b = 0; b < 256; b++)
+	{
+		char byte = b;
+		char *byte_ptr = &byte;
+		size_t byte_len = 1;
+		uint32_t codepoint;
+		char *codepoint_ptr = (char *) &codepoint;
+		size_t codepoint_len = sizeof codepoint;
+
+		(void) iconv (tk->to_utf32_conv, NULL, NULL, NULL, NULL);
+		if (iconv (tk->to_utf32_conv, &byte_ptr, &byte_len,
+			&codepoint_ptr, &codepoint_len) == (size_t) -1)
+		{
+			// The byte doesn't map to anything, which is fine,
+			// but an incomplete sequence means it's not a single-byte encoding
+			if (errno != EILSEQ)
+				goto fail;
+
+			table->to_codepoint[b] = MULTIBYTE_INVALID;
+			continue;
+		}
+
+		// Shift sequences or characters that are only output later
+		if (codepoint_len != 0)
+			goto fail;
+
+		table->to_codepoint[b] = codepoint;
+
+		sbcs_mapping_t *m = &table->from_codepoint[table->from_codepoint_len];
+		m->codepoint = codepoint;
+		m->byte = b;
+		table->from_codepoint_len++;
+	}
+	(void) iconv (tk->to_utf32_conv, NULL, NULL, NULL, NULL);
+
+	qsort (table->from_codepoint, table->from_codepoint_len,
+		sizeof table->from_codepoint[0], sbcs_mapping_compare);
+	return table;
+
+fail:
+	(void) iconv (tk->to_utf32_conv, NULL, NULL, NULL, NULL);
+	free (table);
+	return NULL;
+}
+
+static int
+sbcs_codepoint_compare (const void *key, const void *element)
+{
+	uint32_t codepoint = *(const uint32_t *) key;
+	uint32_t other = ((const sbcs_mapping_t *) element)->codepoint;
+	if (codepoint != other)
+		return codepoint < other ? -1 : 1;
+	return 0;
+}
+
+static void
+fill_multibyte_sbcs (termo_t *tk, termo_key_t *key)
+{
+	sbcs_table_t *table = tk->sbcs;
+	uint32_t codepoint = key->code.codepoint;
+
+	// Most of these encodings are a superset of ASCII, take a shortcut
+	if (codepoint < 256 && table->to_codepoint[codepoint] == codepoint)
+	{
+		key->multibyte[0] = codepoint;
+		key->multibyte[1] = 0;
+		return;
+	}
+
+	const sbcs_mapping_t *m = bsearch (&key->code.codepoint,
+		table->from_codepoint, table->from_codepoint_len,
+		sizeof table->from_codepoint[0], sbcs_codepoint_compare);
+
+	// bsearch() may have found any of the duplicates, pick the first one
+	while (m && m > table->from_codepoint
+		&& m[-1].codepoint == key->code.codepoint)
+		m--;
+
+	key->multibyte[0] = m ? (char) m->byte : MULTIBYTE_INVALID;
+	key->multibyte[1] = 0;
+}
+
+static void
+fill_multibyte (termo_t *tk, termo_key_t *key)
+{
+	if (tk->conv == CONV_UTF8)
+		fill_multibyte_utf8 (key);
+	else if (tk->conv == CONV_SBCS)
+		fill_multibyte_sbcs (tk, key);
+	else
+		fill_multibyte_iconv (tk, key);
+}
+
+// REPLACEMENT CHARACTER
+#define UTF8_INVALID 0xFFFD
+
+// Decodes a UTF-8 sequence, returning its length, or 0 if it's incomplete.
+// Leniently, anything up to six bytes long that looks like UTF-8 is taken,
+// and invalid input comes out as UTF8_INVALID.  Strictly, the results are
+// the same as we get through iconv(): overlong sequences, UTF-16 surrogates
+// and values beyond Unicode are rejected as well, and invalid input comes
+// out as MULTIBYTE_INVALID, skipping a single byte.
+static size_t
+parse_utf8_fast (const unsigned char *bytes, size_t len, bool strict,
+	uint32_t *cp)
+{
+	uint32_t invalid = strict ? MULTIBYTE_INVALID : UTF8_INVALID;
+	size_t nbytes;
+	uint32_t value;
+	unsigned char b0 = bytes[0];
+	if (b0 < 0x80)
+	{
+		// Single byte ASCII
+		*cp = b0;
+		return 1;
+	}
+	else if (b0 < 0xc0 || (strict && b0 < 0xc2))
+	{
+		// Starts with a continuation byte - that's not right,
+		// or an overlong two-byte sequence that is obvious already
+		*cp = invalid;
+		return 1;
+	}
+	else if (b0 < 0xe0)
+	{
+		nbytes = 2;
+		value = b0 & 0x1f;
+	}
+	else if (b0 < 0xf0)
+	{
+		nbytes = 3;
+		value = b0 & 0x0f;
+	}
+	else if (b0 < (strict ? 0xf5 : 0xf8))
+	{
+		nbytes = 4;
+		value = b0 & 0x07;
+	}
+	else if (b0 < 0xfc && !strict)
+	{
+		nbytes = 5;
+		value = b0 & 0x03;
+	}
+	else if (b0 < 0xfe && !strict)
+	{
+		nbytes = 6;
+		value = b0 & 0x01;
+	}
+	else
+	{
+		*cp = invalid;
+		return 1;
+	}
+
+	for (size_t b = 1; b < nbytes; b++)
+	{
+		// Leave *cp alone, callers may have a fallback value there
+		if (b >= len)
+			return 0;
+
+		unsigned char cb = bytes[b];
+		if (cb < 0x80 || cb >= 0xc0)
+		{
+			*cp = invalid;
+			return strict ? 1 : b;
+		}
+		value = value << 6 | (cb & 0x3f);
+	}
+
+	// Overlong sequences, UTF-16 surrogates and values beyond Unicode
+	if (strict && (nbytes > utf8_seqlen (value)
+	 || value > 0x10ffff || (value >= 0xd800 && value <= 0xdfff)))
+	{
+		*cp = invalid;
+		return 1;
+	}
+
+	*cp = value;
+	return nbytes;
+}
+
+static void
+update_multibyte (termo_t *tk, termo_key_t *key)
+{
+	// The user might not be interested, see termo_key_multibyte()
+	if (tk->flags & TERMO_FLAG_LAZY_MULTIBYTE)
+		key->multibyte[0] = 0;
+	else
+		fill_multibyte (tk, key);
+}
+
+const char *
+termo_key_multibyte (termo_t *tk, termo_key_t *key)
+{
+	if (key->type == TERMO_TYPE_KEY && !key->multibyte[0])
+		fill_multibyte (tk, key);
+	return key->multibyte;
+}
+
+static termo_result_t
+parse_multibyte_iconv (termo_t *tk, const unsigned char *bytes, size_t len,
+	uint32_t *cp, size_t *nbytep)
+{
+	size_t multibyte_len = len;
+	char *multibyte_ptr = (char *) bytes;
+	size_t codepoint_len = sizeof *cp;
+	char *codepoint_ptr = (char *) cp;
+
+	// Fingers crossed...
+	errno = 0;
+	iconv (tk->to_utf32_conv,
+		&multibyte_ptr, &multibyte_len, &codepoint_ptr, &codepoint_len);
+
+	// Only one Unicode character could have been processed at maximum,
+	// so let's just set the number of processed bytes to the difference
+	*nbytep = len - multibyte_len;
+
+	// Nothing has been converted, let's examine what happened
+	if (codepoint_ptr == (char *) cp)
+	{
+		if (errno == 0)
+			// The input was probably a shift sequence
+			return TERMO_RES_AGAIN;
+		if (errno == EINVAL)
+			// Incomplete character or shift sequence
+			return TERMO_RES_AGAIN;
+		if (errno == EILSEQ)
+		{
+			// Invalid multibyte sequence in the input, let's try going
+			// byte after byte in hope we skip it completely
+			*cp = MULTIBYTE_INVALID;
+			*nbytep = 1;
+			return TERMO_RES_KEY;
+		}
+
+		// We can't really get E2BIG so what the fuck is going on here
+		abort ();
+	}
+	return TERMO_RES_KEY;
+}
+
+static termo_result_t
+parse_multibyte (termo_t *tk, const unsigned char *bytes, size_t len,
+	uint32_t *cp, size_t *nbytep)
+{
+	if (tk->conv == CONV_UTF8)
+	{
+		*nbytep = parse_utf8_fast (bytes, len, true, cp);
+		return *nbytep ? TERMO_RES_KEY : TERMO_RES_AGAIN;
+	}
+	if (tk->conv == CONV_SBCS)
+	{
+		(void) len;
+		*cp = tk->sbcs->to_codepoint[bytes[0]];
+		*nbytep = 1;
+		return TERMO_RES_KEY;
+	}
+	return parse_multibyte_iconv (tk, bytes, len, cp, nbytep);
+}
+
+static void
+emit_codepoint (termo_t *tk, uint32_t codepoint, termo_key_t *key)
+{
+	if (codepoint == 0)
 	{
 		// ASCII NUL = Ctrl-Space as well as Ctrl-@ but let's prefer
 		// the former to follow the behaviour of libtermkey
@@ -836,7 +1684,7 @@ emit_codepoint (termo_t *tk, uint32_t codepoint, termo_key_t *key)
 	termo_canonicalise (tk, key);
 
 	if (key->type == TERMO_TYPE_KEY)
-		fill_multibyte (tk, key);
+		update_multibyte (tk, key);
 }
 
 void
@@ -859,7 +1707,7 @@ termo_canonicalise (termo_t *tk, termo_key_t *key)
 		{
 			key->type = TERMO_TYPE_KEY;
 			key->code.codepoint = 0x20;
-			fill_multibyte (tk, key);
+			update_multibyte (tk, key);
 		}
 	}
 
@@ -869,35 +1717,261 @@ termo_canonicalise (termo_t *tk, termo_key_t *key)
 			key->code.sym = TERMO_SYM_BACKSPACE;
 }
 
-static termo_result_t
-peekkey (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// Drivers describe their fixed sequences in the order in which they're asked
+// for keys, so a sequence is only added when no earlier one would shadow it,
+// or be shadowed by it.  Once a driver has anything left undescribed, nothing
+// that comes after it can be trusted to be reached, and we stop there.
+
+typedef struct
 {
-	int again = 0;
+	uint16_t *next;         // 256 successors, NULL while there are none
+	automaton_action_t action;
+	uint16_t key;           // Into keys for AUTOMATON_KEY
+	uint8_t partial;
+}
+automaton_node_t;
 
-	if (!tk->is_started)
+struct automaton_builder
+{
+	automaton_node_t *nodes;
+	size_t nnodes, nodes_alloc;
+	keyinfo_t *keys;
+	size_t nkeys, keys_alloc;
+
+	uint8_t driver;         // Bit of the driver describing its sequences
+	bool incomplete;        // Some of its sequences couldn't be added
+	bool failed;            // We've run out of memory
+};
+
+static uint16_t
+new_automaton_node (automaton_builder_t *b)
+{
+	// Just like with the terminfo trie, 16-bit indices are plenty
+	if (b->nnodes > UINT16_MAX)
 	{
-		errno = EINVAL;
-		return TERMO_RES_ERROR;
+		b->incomplete = true;
+		return 0;
 	}
+	if (b->nnodes == b->nodes_alloc)
+	{
+		size_t alloc = b->nodes_alloc ? b->nodes_alloc * 2 : 64;
+		automaton_node_t *nodes = realloc (b->nodes, alloc * sizeof *nodes);
+		if (!nodes)
+		{
+			b->failed = true;
+			return 0;
+		}
 
-#ifdef DEBUG
-	fprintf (stderr, "getkey(force=%d): buffer ", force);
-	print_buffer (tk);
-	fprintf (stderr, "\n");
-#endif
+		b->nodes = nodes;
+		b->nodes_alloc = alloc;
+	}
 
-	if (tk->hightide)
+	automaton_node_t *node = &b->nodes[b->nnodes];
+	node->next = NULL;
+	node->action = AUTOMATON_PREFIX;
+	node->key = 0;
+	node->partial = 0;
+	return b->nnodes++;
+}
+
+static bool
+add_automaton_key (automaton_builder_t *b, const keyinfo_t *key)
+{
+	if (b->nkeys == b->keys_alloc)
 	{
-		tk->buffstart += tk->hightide;
-		tk->buffcount -= tk->hightide;
-		tk->hightide = 0;
+		size_t alloc = b->keys_alloc ? b->keys_alloc * 2 : 64;
+		keyinfo_t *keys = realloc (b->keys, alloc * sizeof *keys);
+		if (!keys)
+			return false;
+
+		b->keys = keys;
+		b->keys_alloc = alloc;
+	}
+
+	b->keys[b->nkeys++] = *key;
+	return true;
+}
+
+static void
+add_sequence (automaton_builder_t *b, const unsigned char *seq, size_t len,
+	automaton_action_t action, const keyinfo_t *key)
+{
+	if (b->failed || !len)
+		return;
+
+	// Fail early for sequences that end or pass through another one
+	uint16_t node = 0;
+	size_t i;
+	for (i = 0; i < len; i++)
+	{
+		automaton_node_t *n = &b->nodes[node];
+		if (n->action != AUTOMATON_PREFIX)
+			goto shadowed;
+		if (!n->next || !n->next[seq[i]])
+			break;
+		node = n->next[seq[i]];
+	}
+	if (i == len)
+		goto shadowed;
+
+	if (action == AUTOMATON_KEY && !add_automaton_key (b, key))
+		goto failed;
+
+	for (; i < len; i++)
+	{
+		uint16_t next = new_automaton_node (b);
+		if (!next)
+			return;
+
+		automaton_node_t *n = &b->nodes[node];
+		if (!n->next && !(n->next = calloc (256, sizeof *n->next)))
+			goto failed;
+
+		n->next[seq[i]] = next;
+		node = next;
+	}
+
+	b->nodes[node].action = action;
+	if (action == AUTOMATON_KEY)
+		b->nodes[node].key = b->nkeys - 1;
+
+	for (i = 0, node = 0; i < len; i++)
+	{
+		b->nodes[node].partial |= b->driver;
+		node = b->nodes[node].next[seq[i]];
 	}
+	return;
+
+shadowed:
+	b->incomplete = true;
+	return;
+failed:
+	b->failed = true;
+}
+
+// Lays the nodes out compactly, with only the extents of their successors
+static automaton_t *
+compile_automaton (const automaton_builder_t *b)
+{
+	size_t nnext = 0;
+	for (size_t i = 0; i < b->nnodes; i++)
+	{
+		const uint16_t *next = b->nodes[i].next;
+		int min = 0, max = 255;
+		if (next)
+		{
+			while (!next[min])
+				min++;
+			while (!next[max])
+				max--;
+			nnext += max - min + 1;
+		}
+	}
+
+	// Ordered by decreasing alignment, so that no padding is needed
+	automaton_t *a = malloc (sizeof *a
+		+ b->nkeys * sizeof *a->keys
+		+ b->nnodes * sizeof *a->states
+		+ nnext * sizeof *a->next);
+	if (!a)
+		return NULL;
+
+	a->keys = (keyinfo_t *) (a + 1);
+	a->states = (automaton_state_t *) (a->keys + b->nkeys);
+	a->next = (uint16_t *) (a->states + b->nnodes);
+	a->complete = 0;
+
+	nnext = 0;
+	for (size_t i = 0; i < b->nnodes; i++)
+	{
+		const automaton_node_t *node = &b->nodes[i];
+		automaton_state_t *s = &a->states[i];
+		s->action = node->action;
+		s->partial = node->partial;
+		s->min = 1;
+		s->max = 0;
+		s->index = node->key;
+		if (!node->next)
+			continue;
+
+		int min = 0, max = 255;
+		while (!node->next[min])
+			min++;
+		while (!node->next[max])
+			max--;
+
+		s->min = min;
+		s->max = max;
+		s->index = nnext;
+		for (int k = min; k <= max; k++)
+			a->next[nnext++] = node->next[k];
+	}
+
+	memcpy (a->keys, b->keys, b->nkeys * sizeof *a->keys);
+	return a;
+}
+
+static automaton_t *
+build_automaton (termo_t *tk)
+{
+	automaton_builder_t b = { .nodes = NULL };
+	automaton_t *a = NULL;
+
+	// The root, which being 0 also stands for no successor
+	(void) new_automaton_node (&b);
+	if (!b.nnodes)
+		goto out;
+
+	// Drivers are told apart by bits, and there are only a few of them
+	uint8_t complete = 0;
+	b.driver = 1;
+	for (termo_driver_node_t *p = tk->drivers; p && b.driver; p = p->next)
+	{
+		if (!p->driver->add_sequences)
+			break;
+
+		b.incomplete = false;
+		bool described = p->driver->add_sequences (tk, p->info, &b);
+		if (b.failed)
+			goto out;
+		if (!described || b.incomplete)
+			break;
+
+		complete |= b.driver;
+		b.driver <<= 1;
+	}
+
+	if ((a = compile_automaton (&b)))
+		a->complete = complete;
+
+out:
+	for (size_t i = 0; i < b.nnodes; i++)
+		free (b.nodes[i].next);
+	free (b.nodes);
+	free (b.keys);
+	return a;
+}
+
+// Asks each driver in turn, then falls back to peekkey_simple().  Drivers in
+// `skip' are already known not to match, or to be waiting for more input
+// if they're also in `partial'.
+static termo_result_t
+peekkey_drivers (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep,
+	uint32_t skip, uint32_t partial)
+{
+	int again = 0;
 
 	termo_result_t ret;
 	termo_driver_node_t *p;
-	for (p = tk->drivers; p; p = p->next)
+	uint32_t bit = 1;
+	for (p = tk->drivers; p; p = p->next, bit <<= 1)
 	{
-		ret = (p->driver->peekkey) (tk, p->info, key, flags, nbytep);
+		if (skip & bit)
+			ret = (partial & bit) ? TERMO_RES_AGAIN : TERMO_RES_NONE;
+		else
+			ret = (p->driver->peekkey) (tk, p->info, key, flags, nbytep);
 
 #ifdef DEBUG
 		fprintf (stderr, "Driver %s yields %s\n",
@@ -906,19 +1980,10 @@ peekkey (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
 
 		switch (ret)
 		{
-			size_t halfsize;
 		case TERMO_RES_KEY:
 #ifdef DEBUG
 			print_key (tk, key); fprintf (stderr, "\n");
 #endif
-			// Slide the data down to stop it running away
-			halfsize = tk->buffsize / 2;
-			if (tk->buffstart > halfsize)
-			{
-				memcpy (tk->buffer, tk->buffer + halfsize, halfsize);
-				tk->buffstart -= halfsize;
-			}
-
 			// Fall-through
 		case TERMO_RES_EOF:
 		case TERMO_RES_ERROR:
@@ -932,22 +1997,336 @@ peekkey (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
 		}
 	}
 
-	if (again)
-		return TERMO_RES_AGAIN;
+	if (again)
+		return TERMO_RES_AGAIN;
+
+	ret = peekkey_simple (tk, key, flags, nbytep);
+
+#ifdef DEBUG
+	fprintf (stderr, "getkey_simple(force=%d) yields %s\n",
+		force, res2str (ret));
+	if (ret == TERMO_RES_KEY)
+	{
+		print_key (tk, key);
+		fprintf (stderr, "\n");
+	}
+#endif
+
+	return ret;
+}
+
+// Walks the automaton for as long as it has anything to say.  Whenever it
+// doesn't find a key, the drivers it doesn't fully describe have to be asked
+// the usual way, so that the results are exactly the same.
+static termo_result_t
+peekkey_automaton (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
+{
+	if (tk->buffcount == 0)
+		return tk->is_closed ? TERMO_RES_EOF : TERMO_RES_NONE;
+
+	const automaton_t *a = tk->automaton;
+	const automaton_state_t *s = &a->states[0];
+	for (size_t pos = 0; pos < tk->buffcount; )
+	{
+		unsigned char b = CHARAT (pos);
+		uint16_t next = 0;
+		if (b >= s->min && b <= s->max)
+			next = a->next[s->index + b - s->min];
+		if (!next)
+		{
+			// Nobody but peekkey_simple() is interested in this byte
+			if (!pos && !tk->sequence_start[b])
+				return peekkey_simple (tk, key, flags, nbytep);
+			return peekkey_drivers (tk, key, flags, nbytep, a->complete, 0);
+		}
+
+		s = &a->states[next];
+		pos++;
+
+		if (s->action == AUTOMATON_KEY)
+		{
+			const keyinfo_t *k = &a->keys[s->index];
+			key->type      = k->type;
+			key->code.sym  = k->sym;
+			key->modifiers = k->modifier_set;
+			*nbytep = pos;
+			return TERMO_RES_KEY;
+		}
+		else if (s->action == AUTOMATON_MOUSE)
+		{
+			hide_bytes (tk, pos);
+
+			termo_result_t mouse_result =
+				(*tk->method.peekkey_mouse) (tk, key, nbytep);
+
+			unhide_bytes (tk, pos);
+
+			if (mouse_result == TERMO_RES_KEY)
+			{
+				*nbytep += pos;
+				return mouse_result;
+			}
+
+			// The following drivers could still have a say in this
+			return peekkey_drivers (tk, key, flags, nbytep, 0, 0);
+		}
+	}
+
+	// We've run out of input in the middle of a sequence
+	return peekkey_drivers (tk, key, flags, nbytep, a->complete, s->partial);
+}
+
+// Decodes the key at the start of the buffer through the drivers
+static termo_result_t
+peekkey_decode (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
+{
+	if (tk->automaton && (tk->flags & TERMO_FLAG_AUTOMATON))
+		return peekkey_automaton (tk, key, flags, nbytep);
+
+	// Nobody but peekkey_simple() is interested in this byte
+	if (tk->buffcount && !tk->sequence_start[CHARAT (0)])
+		return peekkey_simple (tk, key, flags, nbytep);
+	return peekkey_drivers (tk, key, flags, nbytep, 0, 0);
+}
+
+// Terminals write whole sequences at once, so an Escape that has ended
+// the last read, with nothing else having arrived since, is a keypress
+static bool
+escape_at_boundary (termo_t *tk)
+{
+	if (tk->buffcount != 1 || CHARAT (0) != 0x1b
+	 || tk->eaten + 1 != tk->read_boundary)
+		return false;
+	if (tk->fd == -1)
+		return true;
+
+	struct pollfd pfd = { .fd = tk->fd, .events = POLLIN };
+	return poll (&pfd, 1, 0) == 0;
+}
+
+static termo_result_t
+peekkey (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
+{
+	if (!tk->is_started)
+	{
+		errno = EINVAL;
+		return TERMO_RES_ERROR;
+	}
+
+#ifdef DEBUG
+	fprintf (stderr, "getkey(force=%d): buffer ", force);
+	print_buffer (tk);
+	fprintf (stderr, "\n");
+#endif
+
+	if (tk->hightide)
+	{
+		eat_bytes (tk, tk->hightide);
+		tk->hightide = 0;
+	}
+	tk->csi_info_valid = false;
+	key->event = TERMO_KEY_PRESS;
+
+	// Don't wait for more after a lone Escape, except within pastes,
+	// which arrive in arbitrary pieces
+	if ((tk->flags & TERMO_FLAG_READBOUNDARY) && !tk->in_paste
+	 && escape_at_boundary (tk))
+		flags |= PEEKKEY_FORCE;
+
+	// Pasted data mustn't be interpreted, only searched for the end marker
+	if (tk->in_paste)
+		return peekkey_paste (tk, key, flags, nbytep);
+
+	// Plain text doesn't need to go through the drivers at all
+	if (tk->can_scan_plain)
+	{
+		if (!tk->plain_run)
+			tk->plain_run = scan_plain (tk);
+		if (tk->plain_run)
+			return peekkey_simple (tk, key, flags, nbytep);
+	}
+
+	termo_result_t ret = peekkey_decode (tk, key, flags, nbytep);
+	if (ret != TERMO_RES_ALT_PREFIX)
+		return ret;
+
+	// Escape-prefixed keys are decoded with the Escape out of sight,
+	// as if they were the whole input, and with Alt added.  This time
+	// peekkey_simple() returns any Escape as it is, so we're done then.
+	hide_bytes (tk, 1);
+
+	ret = peekkey_decode (tk, key, flags | PEEKKEY_ALT_PREFIXED, nbytep);
+
+	unhide_bytes (tk, 1);
+
+	if (ret == TERMO_RES_KEY)
+	{
+		key->modifiers |= TERMO_KEYMOD_ALT;
+		(*nbytep)++;
+	}
+	return ret;
+}
+
+// Finds out how long a run of printable characters is at the start of the
+// buffer, limited to a contiguous part of it.  Returns the character count.
+static size_t
+measure_text (termo_t *tk, size_t *lenp)
+{
+	size_t start = tk->buffstart & tk->buffmask;
+	size_t limit = tk->buffmask + 1 - start;
+	if (limit > tk->buffcount)
+		limit = tk->buffcount;
+	if (limit > INT_MAX)
+		limit = INT_MAX;
+
+	const unsigned char *p = tk->buffer + start;
+	bool space_is_symbol = tk->canonflags & TERMO_CANON_SPACESYMBOL;
+
+	size_t len = 0, count = 0;
+	while (len < limit && !tk->sequence_start[p[len]])
+	{
+		unsigned char b = p[len];
+		if (b < 0x20 || b == 0x7f || (b == 0x20 && space_is_symbol))
+			break;
+
+		// Stateful encodings may even change the meaning of ASCII
+		if (b < 0x80 && tk->conv != CONV_ICONV)
+		{
+			len++;
+			count++;
+			continue;
+		}
+
+		uint32_t codepoint;
+		size_t nbytes;
+		if (parse_multibyte (tk, p + len, limit - len, &codepoint, &nbytes)
+			!= TERMO_RES_KEY)
+			break;
+
+		// Controls and invalid sequences need to go out as separate keys
+		if (codepoint < 0x20 || (codepoint >= 0x7f && codepoint < 0xa0)
+		 || (codepoint == MULTIBYTE_INVALID && b != MULTIBYTE_INVALID)
+		 || (codepoint == 0x20 && space_is_symbol))
+			break;
+
+		len += nbytes;
+		count++;
+	}
+
+	*lenp = len;
+	return count;
+}
+
+static termo_result_t
+peekkey_text (termo_t *tk, termo_key_t *key, size_t *nbytep)
+{
+	size_t len, count = measure_text (tk, &len);
+	if (!count)
+		return TERMO_RES_NONE;
+
+	// Like with unknown CSIs, the data is only eaten on the next call
+	key->type = TERMO_TYPE_TEXT;
+	key->code.text.len = len;
+	key->code.text.count = count;
+	key->modifiers = 0;
+	key->multibyte[0] = 0;
+
+	tk->hightide = len;
+	*nbytep = 0;
+	return TERMO_RES_KEY;
+}
+
+termo_result_t
+termo_interpret_text (termo_t *tk, const termo_key_t *key,
+	const char **text, size_t *len, size_t *count)
+{
+	if (key->type != TERMO_TYPE_TEXT)
+		return TERMO_RES_NONE;
+	if (tk->hightide == 0 || tk->hightide != (size_t) key->code.text.len)
+		return TERMO_RES_NONE;
+
+	// The run has been limited so that this is contiguous
+	if (text)
+		*text = (const char *) &CHARAT (0);
+	if (len)
+		*len = key->code.text.len;
+	if (count)
+		*count = key->code.text.count;
+	return TERMO_RES_KEY;
+}
+
+static const char paste_end[] = "\x1b[201~";
+#define PASTE_END_LEN (sizeof paste_end - 1)
+
+// Returns pasted data in pieces that are as large as the buffer allows,
+// so that pastes of any size can stream through it
+static termo_result_t
+peekkey_paste (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
+{
+	if (tk->buffcount == 0)
+		return tk->is_closed ? TERMO_RES_EOF : TERMO_RES_NONE;
+
+	key->modifiers = 0;
+	key->multibyte[0] = 0;
+
+	size_t start = tk->buffstart & tk->buffmask;
+	size_t limit = tk->buffmask + 1 - start;
+	if (limit > tk->buffcount)
+		limit = tk->buffcount;
+	if (limit > INT_MAX)
+		limit = INT_MAX;
+
+	const unsigned char *p = tk->buffer + start;
+	size_t len = 0;
+	if (p[0] == 0x1b)
+	{
+		size_t matched = 0;
+		while (matched < PASTE_END_LEN && matched < tk->buffcount
+			&& CHARAT (matched) == (unsigned char) paste_end[matched])
+			matched++;
+
+		if (matched == PASTE_END_LEN)
+		{
+			key->type = TERMO_TYPE_PASTE_END;
+			*nbytep = PASTE_END_LEN;
+			return TERMO_RES_KEY;
+		}
+
+		// The end marker may yet arrive in full
+		if (matched == tk->buffcount
+		 && !(flags & PEEKKEY_FORCE) && !tk->is_closed)
+			return TERMO_RES_AGAIN;
+
+		len = 1;
+	}
+
+	const unsigned char *esc = memchr (p + len, 0x1b, limit - len);
+	len = esc ? (size_t) (esc - p) : limit;
 
-	ret = peekkey_simple (tk, key, flags, nbytep);
+	// Like with unknown CSIs, the data is only eaten on the next call
+	key->type = TERMO_TYPE_PASTE_DATA;
+	key->code.paste.len = len;
 
-#ifdef DEBUG
-	fprintf (stderr, "getkey_simple(force=%d) yields %s\n",
-		force, res2str (ret));
-	if (ret == TERMO_RES_KEY)
-	{
-		print_key (tk, key);
-		fprintf (stderr, "\n");
-	}
-#endif
+	tk->hightide = len;
+	*nbytep = 0;
+	return TERMO_RES_KEY;
+}
 
-	return ret;
+termo_result_t
+termo_interpret_paste (termo_t *tk, const termo_key_t *key,
+	const char **data, size_t *len)
+{
+	if (key->type != TERMO_TYPE_PASTE_DATA)
+		return TERMO_RES_NONE;
+	if (tk->hightide == 0 || tk->hightide != (size_t) key->code.paste.len)
+		return TERMO_RES_NONE;
+
+	// The piece has been limited so that this is contiguous
+	if (data)
+		*data = (const char *) &CHARAT (0);
+	if (len)
+		*len = key->code.paste.len;
+	return TERMO_RES_KEY;
 }
 
 static termo_result_t
@@ -956,12 +2335,20 @@ peekkey_simple (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
 	if (tk->buffcount == 0)
 		return tk->is_closed ? TERMO_RES_EOF : TERMO_RES_NONE;
 
+	if ((tk->flags & TERMO_FLAG_TEXT) && !(tk->flags & TERMO_FLAG_RAW)
+	 && !(flags & PEEKKEY_ALT_PREFIXED))
+	{
+		termo_result_t res = peekkey_text (tk, key, nbytep);
+		if (res != TERMO_RES_NONE)
+			return res;
+	}
+
 	unsigned char b0 = CHARAT (0);
 	if (b0 == 0x1b)
 	{
 		if (flags & PEEKKEY_ALT_PREFIXED)
 		{
-			// We got back here recursively, which means that no driver has
+			// We got back here after a prefix, which means that no driver has
 			// returned TERMO_RES_AGAIN -> just return the Escape.  Otherwise
 			// we would interpret an indefinite number of <Esc>s as Alt+Esc.
 			(*tk->method.emit_codepoint) (tk, b0, key);
@@ -982,32 +2369,8 @@ peekkey_simple (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
 			return TERMO_RES_KEY;
 		}
 
-		// Try another key there
-		tk->buffstart++;
-		tk->buffcount--;
-
-		// Run the full driver
-		termo_result_t metakey_result =
-			peekkey (tk, key, flags | PEEKKEY_ALT_PREFIXED, nbytep);
-
-		tk->buffstart--;
-		tk->buffcount++;
-
-		switch (metakey_result)
-		{
-		case TERMO_RES_KEY:
-			key->modifiers |= TERMO_KEYMOD_ALT;
-			(*nbytep)++;
-			break;
-
-		case TERMO_RES_NONE:
-		case TERMO_RES_EOF:
-		case TERMO_RES_AGAIN:
-		case TERMO_RES_ERROR:
-			break;
-		}
-
-		return metakey_result;
+		// Let peekkey() try another key there
+		return TERMO_RES_ALT_PREFIX;
 	}
 	else if (!(tk->flags & TERMO_FLAG_RAW))
 	{
@@ -1015,8 +2378,10 @@ peekkey_simple (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
 		//   specified in the terminfo entry key_backspace.  Just because it
 		//   doesn't form an escape sequence.
 		uint32_t codepoint = MULTIBYTE_INVALID;
-		termo_result_t res = parse_multibyte
-			(tk, tk->buffer + tk->buffstart, tk->buffcount, &codepoint, nbytep);
+		unsigned char scratch[MB_LEN_MAX];
+		size_t len = tk->buffcount < MB_LEN_MAX ? tk->buffcount : MB_LEN_MAX;
+		termo_result_t res = parse_multibyte (tk,
+			peek_bytes (tk, 0, len, scratch), len, &codepoint, nbytep);
 
 		if (res == TERMO_RES_AGAIN && (flags & PEEKKEY_FORCE))
 		{
@@ -1048,78 +2413,10 @@ peekkey_simple (termo_t *tk, termo_key_t *key, int flags, size_t *nbytep)
 	}
 }
 
-// REPLACEMENT CHARACTER
-#define UTF8_INVALID 0xFFFD
-
-static size_t
-parse_utf8_fast (const unsigned char *bytes, size_t len, uint32_t *cp)
-{
-	size_t nbytes;
-	unsigned char b0 = bytes[0];
-	if (b0 < 0x80)
-	{
-		// Single byte ASCII
-		*cp = b0;
-		return 1;
-	}
-	else if (b0 < 0xc0)
-	{
-		// Starts with a continuation byte - that's not right
-		*cp = UTF8_INVALID;
-		return 1;
-	}
-	else if (b0 < 0xe0)
-	{
-		nbytes = 2;
-		*cp = b0 & 0x1f;
-	}
-	else if (b0 < 0xf0)
-	{
-		nbytes = 3;
-		*cp = b0 & 0x0f;
-	}
-	else if (b0 < 0xf8)
-	{
-		nbytes = 4;
-		*cp = b0 & 0x07;
-	}
-	else if (b0 < 0xfc)
-	{
-		nbytes = 5;
-		*cp = b0 & 0x03;
-	}
-	else if (b0 < 0xfe)
-	{
-		nbytes = 6;
-		*cp = b0 & 0x01;
-	}
-	else
-	{
-		*cp = UTF8_INVALID;
-		return 1;
-	}
-
-	for (size_t b = 1; b < nbytes; b++)
-	{
-		if (b >= len)
-			return 0;
-
-		unsigned char cb = bytes[b];
-		if (cb < 0x80 || cb >= 0xc0)
-		{
-			*cp = UTF8_INVALID;
-			return b;
-		}
-		*cp <<= 6;
-		*cp |= cb & 0x3f;
-	}
-	return nbytes;
-}
-
 static termo_result_t
 parse_1005_value (const unsigned char **bytes, size_t *len, uint32_t *cp)
 {
-	size_t nbytes = parse_utf8_fast (*bytes, *len, cp);
+	size_t nbytes = parse_utf8_fast (*bytes, *len, false, cp);
 	if (nbytes == 0)
 		return TERMO_RES_AGAIN;
 
@@ -1140,15 +2437,19 @@ peekkey_mouse (termo_t *tk, termo_key_t *key, size_t *nbytep)
 
 	if (tk->mouse_proto == TERMO_MOUSE_PROTO_UTF8)
 	{
-		const unsigned char *buff = tk->buffer + tk->buffstart;
-		size_t len = tk->buffcount;
+		// Three UTF-8 sequences of up to 6 bytes each
+		unsigned char scratch[3 * 6];
+		size_t peeked = tk->buffcount < sizeof scratch
+			? tk->buffcount : sizeof scratch;
+		const unsigned char *buff = peek_bytes (tk, 0, peeked, scratch);
+		size_t len = peeked;
 
 		if (parse_1005_value (&buff, &len, &b) == TERMO_RES_AGAIN
 		 || parse_1005_value (&buff, &len, &x) == TERMO_RES_AGAIN
 		 || parse_1005_value (&buff, &len, &y) == TERMO_RES_AGAIN)
 			return TERMO_RES_AGAIN;
 
-		*nbytep = tk->buffcount - len;
+		*nbytep = peeked - len;
 	}
 	else
 	{
@@ -1173,20 +2474,113 @@ peekkey_mouse (termo_t *tk, termo_key_t *key, size_t *nbytep)
 	return TERMO_RES_KEY;
 }
 
+// Calls peekkey() in force mode, reusing the last result if the input
+// hasn't changed since then, as is the case after a timeout
+static termo_result_t
+peekkey_force (termo_t *tk, termo_key_t *key, size_t *nbytep)
+{
+	// Everything peekkey() does before decoding still applies
+	if (tk->forced.valid && tk->is_started && !tk->hightide
+	 && tk->forced.eaten == tk->eaten
+	 && tk->forced.buffcount == tk->buffcount)
+	{
+		tk->csi_info_valid = false;
+		*key = tk->forced.key;
+		*nbytep = tk->forced.nbytes;
+		tk->hightide = tk->forced.hightide;
+		return TERMO_RES_KEY;
+	}
+
+	// Unknown CSIs keep their arguments around, which may not survive
+	termo_result_t ret = peekkey (tk, key, PEEKKEY_FORCE, nbytep);
+	if ((tk->forced.valid = (ret == TERMO_RES_KEY && !tk->csi_info_valid)))
+	{
+		tk->forced.eaten = tk->eaten;
+		tk->forced.buffcount = tk->buffcount;
+		tk->forced.key = *key;
+		tk->forced.nbytes = *nbytep;
+		tk->forced.hightide = tk->hightide;
+	}
+	return ret;
+}
+
+// Consumes a key that has been peeked, including any state it changes,
+// so that peeks which are discarded or repeated don't have any effect
+static void
+eat_key (termo_t *tk, const termo_key_t *key, size_t nbytes)
+{
+	eat_bytes (tk, nbytes);
+	if (key->type == TERMO_TYPE_PASTE_BEGIN)
+		tk->in_paste = true;
+	else if (key->type == TERMO_TYPE_PASTE_END)
+		tk->in_paste = false;
+	// The reply to our kitty keyboard protocol query, CSI ? flags u
+	else if (key->type == TERMO_TYPE_UNKNOWN_CSI && tk->csi_info_valid
+	 && tk->csi_info.command == ('u' | '?' << 8)
+	 && tk->csi_info.nargs > 0 && tk->csi_info.args[0] >= 0)
+		tk->reported_keyboard_flags = tk->csi_info.args[0];
+}
+
 termo_result_t
 termo_getkey (termo_t *tk, termo_key_t *key)
 {
 	size_t nbytes = 0;
 	termo_result_t ret = peekkey (tk, key, 0, &nbytes);
+	observe_timing (tk, ret, key);
 
 	if (ret == TERMO_RES_KEY)
-		eat_bytes (tk, nbytes);
+		eat_key (tk, key, nbytes);
 
 	if (ret == TERMO_RES_AGAIN)
+	{
 		// Call peekkey() again in force mode to obtain whatever it can
-		(void) peekkey (tk, key, PEEKKEY_FORCE, &nbytes);
-		// Don't eat it yet though
+		(void) peekkey_force (tk, key, &nbytes);
+		// Don't eat it yet though, not even through the hightide
+		tk->hightide = 0;
+	}
+
+	return ret;
+}
+
+// Retrieves up to `max' keys at once.  The return value is what termo_getkey()
+// would have returned for the key following the last one stored, or KEY when
+// the array has been filled.  Stops early after unknown CSIs and text runs.
+termo_result_t
+termo_getkeys (termo_t *tk, termo_key_t *keys, size_t max, size_t *nkeys)
+{
+	*nkeys = 0;
+	if (!tk->is_started)
+	{
+		errno = EINVAL;
+		return TERMO_RES_ERROR;
+	}
+
+	termo_result_t ret = TERMO_RES_KEY;
+	while (*nkeys < max)
+	{
+		termo_key_t *key = &keys[*nkeys];
+		size_t nbytes = 0;
+		ret = peekkey (tk, key, 0, &nbytes);
+		observe_timing (tk, ret, key);
+		if (ret != TERMO_RES_KEY)
+			break;
+
+		eat_key (tk, key, nbytes);
+		(*nkeys)++;
 
+		// termo_interpret_csi() and termo_interpret_text()
+		// only work on the most recent key
+		if (tk->hightide || tk->csi_info_valid)
+			break;
+	}
+
+	if (ret == TERMO_RES_AGAIN)
+	{
+		// Just like termo_getkey(), provide whatever we can
+		size_t nbytes = 0;
+		(void) peekkey_force (tk, &keys[*nkeys], &nbytes);
+		tk->hightide = 0;
+	}
 	return ret;
 }
 
@@ -1194,14 +2588,83 @@ termo_result_t
 termo_getkey_force (termo_t *tk, termo_key_t *key)
 {
 	size_t nbytes = 0;
-	termo_result_t ret = peekkey (tk, key, PEEKKEY_FORCE, &nbytes);
+	termo_result_t ret = peekkey_force (tk, key, &nbytes);
 
+	// The sequence has timed out, there's nothing to learn from it
+	tk->partial_since = 0;
 	if (ret == TERMO_RES_KEY)
-		eat_bytes (tk, nbytes);
+		eat_key (tk, key, nbytes);
 
 	return ret;
 }
 
+// Reads as much input as there is room for, but at most `limit' bytes.
+// With `timed', the terminal is expected to have VMIN at zero, so that getting
+// no input doesn't necessarily mean the end of it, and it's up to the caller
+// to find out.
+static termo_result_t
+read_input (termo_t *tk, bool timed, size_t limit)
+{
+	if (tk->buffsize_max > tk->buffsize_base)
+	{
+		// Take everything the kernel has for us in one go
+		size_t pending = pending_bytes (tk);
+		if (pending > limit)
+			pending = limit;
+		if (!tk->buffcount && tk->buffsize > tk->buffsize_base
+		 && pending <= tk->buffsize_base)
+			// Idle again, give the memory back
+			(void) resize_buffer (tk, tk->buffsize_base);
+		else
+			grow_buffer (tk, tk->buffcount + (pending ? pending : 1));
+	}
+
+	// Not expecting it ever to be greater but doesn't hurt to handle that
+	if (tk->buffcount >= tk->buffsize)
+	{
+		errno = ENOMEM;
+		return TERMO_RES_ERROR;
+	}
+
+	struct iovec iov[2];
+	int iovcnt = free_segments (tk, iov);
+	if (iov[0].iov_len >= limit)
+	{
+		iov[0].iov_len = limit;
+		iovcnt = 1;
+	}
+	else if (iovcnt == 2 && iov[0].iov_len + iov[1].iov_len > limit)
+		iov[1].iov_len = limit - iov[0].iov_len;
+
+	ssize_t len;
+retry:
+	len = readv (tk->fd, iov, iovcnt);
+
+	if (len == -1)
+	{
+		if (errno == EAGAIN)
+			return TERMO_RES_NONE;
+		if (errno == EINTR && !(tk->flags & TERMO_FLAG_EINTR))
+			goto retry;
+		return TERMO_RES_ERROR;
+	}
+	if (len < 1)
+	{
+		if (timed)
+			return TERMO_RES_NONE;
+
+		tk->is_closed = true;
+		tk->forced.valid = false;
+		return TERMO_RES_NONE;
+	}
+	tk->buffcount += len;
+	tk->forced.valid = false;
+	tk->read_boundary = tk->eaten + tk->buffcount;
+	if (tk->waittime_max)
+		tk->last_input = monotonic_usec ();
+	return TERMO_RES_AGAIN;
+}
+
 termo_result_t
 termo_waitkey (termo_t *tk, termo_key_t *key)
 {
@@ -1223,10 +2686,22 @@ termo_waitkey (termo_t *tk, termo_key_t *key)
 			return ret;
 
 		case TERMO_RES_NONE:
-			ret = termo_advisereadable (tk);
+		{
+			// Switching VMIN back and forth costs more system calls than
+			// a wakeup, so wait with VTIME once more.  Only when there's
+			// no input for that long, block until there is input again,
+			// rather than waking up after every VTIME.
+			if (tk->vtime && tk->vtime == desired_vtime (tk))
+				ret = read_input (tk, true, SIZE_MAX);
+			if (ret == TERMO_RES_NONE)
+			{
+				set_vtime (tk, 0);
+				ret = termo_advisereadable (tk);
+			}
 			if (ret == TERMO_RES_ERROR)
 				return ret;
 			break;
+		}
 
 		case TERMO_RES_AGAIN:
 		{
@@ -1235,6 +2710,20 @@ termo_waitkey (termo_t *tk, termo_key_t *key)
 				// so just go with what we have
 				return termo_getkey_force (tk, key);
 
+			set_vtime (tk, desired_vtime (tk));
+			if (tk->vtime)
+			{
+				// The kernel waits for the rest of the sequence in read(),
+				// sparing us a poll() call and the associated wakeup.
+				// Should the input end here, we'll find out next time.
+				ret = read_input (tk, true, SIZE_MAX);
+				if (ret == TERMO_RES_ERROR)
+					return ret;
+				if (ret == TERMO_RES_NONE)
+					return termo_getkey_force (tk, key);
+				break;
+			}
+
 			struct pollfd fd;
 retry:
 			fd.fd = tk->fd;
@@ -1273,50 +2762,47 @@ termo_advisereadable (termo_t *tk)
 		errno = EBADF;
 		return TERMO_RES_ERROR;
 	}
+	return read_input (tk, false, SIZE_MAX);
+}
 
-	if (tk->buffstart)
-	{
-		memmove (tk->buffer, tk->buffer + tk->buffstart, tk->buffcount);
-		tk->buffstart = 0;
-	}
-
-	// Not expecting it ever to be greater but doesn't hurt to handle that
-	if (tk->buffcount >= tk->buffsize)
+termo_result_t
+termo_advisereadable_drain (termo_t *tk, size_t budget, size_t *nbytes)
+{
+	*nbytes = 0;
+	if (tk->fd == -1)
 	{
-		errno = ENOMEM;
+		errno = EBADF;
 		return TERMO_RES_ERROR;
 	}
+	if (!budget)
+		budget = SIZE_MAX;
+
+	// Unlike termo_advisereadable(), keep going for as long as the kernel
+	// has more for us, rather than going through the caller's event loop
+	// once for each buffer's worth of input.  Asking for the amount
+	// of pending input beforehand makes this safe for blocking descriptors.
+	size_t start = tk->buffcount;
+	termo_result_t ret = read_input (tk, false, budget);
+	while (ret == TERMO_RES_AGAIN)
+	{
+		*nbytes = tk->buffcount - start;
+		if (*nbytes >= budget
+		 || (tk->buffcount >= tk->buffsize && tk->buffsize >= tk->buffsize_max)
+		 || !pending_bytes (tk))
+			break;
 
-	ssize_t len;
-retry:
-	len = read (tk->fd, tk->buffer + tk->buffcount,
-		tk->buffsize - tk->buffcount);
-
-	if (len == -1)
-	{
-		if (errno == EAGAIN)
-			return TERMO_RES_NONE;
-		if (errno == EINTR && !(tk->flags & TERMO_FLAG_EINTR))
-			goto retry;
-		return TERMO_RES_ERROR;
-	}
-	if (len < 1)
-	{
-		tk->is_closed = true;
-		return TERMO_RES_NONE;
+		// Whatever we have read so far is a success on its own,
+		// any error will show up again with the next call
+		if (read_input (tk, false, budget - *nbytes) != TERMO_RES_AGAIN)
+			break;
 	}
-	tk->buffcount += len;
-	return TERMO_RES_AGAIN;
+	return ret;
 }
 
 size_t
 termo_push_bytes (termo_t *tk, const char *bytes, size_t len)
 {
-	if (tk->buffstart)
-	{
-		memmove (tk->buffer, tk->buffer + tk->buffstart, tk->buffcount);
-		tk->buffstart = 0;
-	}
+	grow_buffer (tk, tk->buffcount + len);
 
 	// Not expecting it ever to be greater but doesn't hurt to handle that
 	if (tk->buffcount >= tk->buffsize)
@@ -1329,8 +2815,22 @@ termo_push_bytes (termo_t *tk, const char *bytes, size_t len)
 		len = tk->buffsize - tk->buffcount;
 
 	// memcpy(), not strncpy() in case of null bytes in input
-	memcpy (tk->buffer + tk->buffcount, bytes, len);
+	struct iovec iov[2];
+	size_t done = 0;
+	for (int i = 0, iovcnt = free_segments (tk, iov); i < iovcnt; i++)
+	{
+		size_t chunk = len - done;
+		if (chunk > iov[i].iov_len)
+			chunk = iov[i].iov_len;
+
+		memcpy (iov[i].iov_base, bytes + done, chunk);
+		done += chunk;
+	}
 	tk->buffcount += len;
+	tk->forced.valid = false;
+	tk->read_boundary = tk->eaten + tk->buffcount;
+	if (tk->waittime_max)
+		tk->last_input = monotonic_usec ();
 
 	return len;
 }
@@ -1577,6 +3077,18 @@ termo_strfkey_generic (termo_t *tk, char *buffer, size_t len,
 	case TERMO_TYPE_FOCUS:
 		l = snprintf (buffer + pos, len - pos, "Focus(%d)", key->code.focused);
 		break;
+	case TERMO_TYPE_TEXT:
+		l = snprintf (buffer + pos, len - pos, "Text(%d)", key->code.text.count);
+		break;
+	case TERMO_TYPE_PASTE_BEGIN:
+		l = snprintf (buffer + pos, len - pos, "PasteBegin");
+		break;
+	case TERMO_TYPE_PASTE_DATA:
+		l = snprintf (buffer + pos, len - pos, "Paste(%d)", key->code.paste.len);
+		break;
+	case TERMO_TYPE_PASTE_END:
+		l = snprintf (buffer + pos, len - pos, "PasteEnd");
+		break;
 	case TERMO_TYPE_POSITION:
 		l = snprintf (buffer + pos, len - pos, "Position");
 		break;
@@ -1629,38 +3141,11 @@ termo_strfkey (termo_t *tk, char *buffer, size_t len,
 		(tk, buffer, len, key, format, strfkey_emit_locale);
 }
 
-static inline size_t
-utf8_seqlen (uint32_t codepoint)
-{
-	if (codepoint < 0x0000080) return 1;
-	if (codepoint < 0x0000800) return 2;
-	if (codepoint < 0x0010000) return 3;
-	if (codepoint < 0x0200000) return 4;
-	if (codepoint < 0x4000000) return 5;
-	return 6;
-}
-
 static const char *
 strfkey_emit_utf8 (termo_t *tk, termo_key_t *key, char buf[])
 {
 	(void) tk;
-	uint32_t codepoint = key->code.codepoint;
-	int nbytes = utf8_seqlen (codepoint);
-	buf[nbytes] = 0;
-
-	// This is easier done backwards
-	for (int b = nbytes; b-- > 1; codepoint >>= 6)
-		buf[b] = 0x80 | (codepoint & 0x3f);
-
-	switch (nbytes)
-	{
-	case 1: buf[0] =        (codepoint & 0x7f); break;
-	case 2: buf[0] = 0xc0 | (codepoint & 0x1f); break;
-	case 3: buf[0] = 0xe0 | (codepoint & 0x0f); break;
-	case 4: buf[0] = 0xf0 | (codepoint & 0x07); break;
-	case 5: buf[0] = 0xf8 | (codepoint & 0x03); break;
-	case 6: buf[0] = 0xfc | (codepoint & 0x01); break;
-	}
+	utf8_encode (key->code.codepoint, buf);
 	return buf;
 }
 
@@ -1687,6 +3172,7 @@ termo_strpkey_generic (termo_t *tk, const char *str, termo_key_t *key,
 		!!(format & TERMO_FORMAT_LOWERMOD) * 4];
 
 	key->modifiers = 0;
+	key->event = TERMO_KEY_PRESS;
 
 	if ((format & TERMO_FORMAT_CARETCTRL) && str[0] == '^' && str[1])
 	{
@@ -1768,7 +3254,7 @@ parse_utf8 (termo_t *tk, const unsigned char *bytes, size_t len,
 	uint32_t *cp, size_t *nbytep)
 {
 	(void) tk;
-	size_t nbytes = parse_utf8_fast (bytes, len, cp);
+	size_t nbytes = parse_utf8_fast (bytes, len, false, cp);
 	if (nbytes == 0)
 		return TERMO_RES_AGAIN;
 
@@ -1833,6 +3319,21 @@ termo_keycmp (termo_t *tk,
 	}
 	case TERMO_TYPE_FOCUS:
 		return key1.code.focused - key2.code.focused;
+	case TERMO_TYPE_TEXT:
+	{
+		int cmp = memcmp (&key1.code.text, &key2.code.text,
+			sizeof key1.code.text);
+		if (cmp != 0)
+			return cmp;
+		break;
+	}
+	case TERMO_TYPE_PASTE_DATA:
+		if (key1.code.paste.len != key2.code.paste.len)
+			return key1.code.paste.len - key2.code.paste.len;
+		break;
+	case TERMO_TYPE_PASTE_BEGIN:
+	case TERMO_TYPE_PASTE_END:
+		break;
 	case TERMO_TYPE_POSITION:
 	{
 		int line1, col1, line2, col2;
@@ -1854,5 +3355,7 @@ termo_keycmp (termo_t *tk,
 		return value1 - value2;
 	}
 	}
+	// The event is deliberately ignored, so that keys parsed by
+	// termo_strpkey() match presses, repeats and releases alike
 	return key1.modifiers - key2.modifiers;
 }
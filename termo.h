@@ -98,6 +98,10 @@ enum termo_type
 	TERMO_TYPE_POSITION,
 	TERMO_TYPE_MODEREPORT,
 	TERMO_TYPE_FOCUS,
+	TERMO_TYPE_TEXT,
+	TERMO_TYPE_PASTE_BEGIN,
+	TERMO_TYPE_PASTE_DATA,
+	TERMO_TYPE_PASTE_END,
 	// add other recognised types here
 
 	TERMO_TYPE_UNKNOWN_CSI = -1
@@ -144,6 +148,24 @@ enum termo_mouse_tracking
 	TERMO_MOUSE_TRACKING_MOVE
 };
 
+typedef enum termo_key_event termo_key_event_t;
+enum termo_key_event
+{
+	TERMO_KEY_PRESS,
+	TERMO_KEY_REPEAT,
+	TERMO_KEY_RELEASE
+};
+
+// Progressive enhancements of the kitty keyboard protocol
+enum
+{
+	TERMO_KEYBOARD_DISAMBIGUATE = 1 << 0, // Escape and modified keys as CSI u
+	TERMO_KEYBOARD_EVENTS       = 1 << 1, // Report repeats and releases
+	TERMO_KEYBOARD_ALTERNATES   = 1 << 2, // Report alternate key codes
+	TERMO_KEYBOARD_ALL_KEYS     = 1 << 3, // Even plain text as CSI u
+	TERMO_KEYBOARD_TEXT         = 1 << 4  // Report associated text
+};
+
 enum
 {
 	TERMO_KEYMOD_SHIFT = 1 << 0,
@@ -169,14 +191,48 @@ struct termo_key
 		// TERMO_TYPE_MOUSE
 		// opaque, see termo_interpret_mouse()
 		struct { int16_t x, y, info; } mouse;
+
+		// TERMO_TYPE_TEXT
+		// opaque, see termo_interpret_text()
+		struct { int len, count; } text;
+
+		// TERMO_TYPE_PASTE_DATA
+		// opaque, see termo_interpret_paste()
+		struct { int len; } paste;
 	} code;
 
 	int modifiers;
+	// Only other than a press with TERMO_KEYBOARD_EVENTS
+	termo_key_event_t event;
 
 	// The raw multibyte sequence for the key
 	char multibyte[MB_LEN_MAX + 1];
 };
 
+// How much of an unknown CSI sequence gets parsed out, the rest is ignored
+#define TERMO_CSI_MAX_ARGS          16
+#define TERMO_CSI_MAX_SUBARGS       32
+#define TERMO_CSI_MAX_INTERMEDIATES  4
+
+// TERMO_TYPE_UNKNOWN_CSI, see termo_interpret_csi_info()
+typedef struct termo_csi_info termo_csi_info_t;
+struct termo_csi_info
+{
+	unsigned long command; // As returned by termo_interpret_csi()
+	char initial; // The private marker among < = > ? if any
+	char intermediates[TERMO_CSI_MAX_INTERMEDIATES + 1];
+	char final;
+
+	size_t nargs; // Arguments separated by semicolons
+	long args[TERMO_CSI_MAX_ARGS]; // -1 where an argument is missing
+
+	// Sub-parameters separated by colons, as in 38:2::255:0:0.  Those
+	// following args[i] are subargs[subargi[i]] up to subargs[subargi[i + 1]].
+	size_t nsubargs;
+	long subargs[TERMO_CSI_MAX_SUBARGS]; // -1 where one is missing
+	unsigned char subargi[TERMO_CSI_MAX_ARGS + 1];
+};
+
 typedef struct termo termo_t;
 
 enum
@@ -196,7 +252,19 @@ enum
 	// Return ERROR on signal (EINTR) rather than retry
 	TERMO_FLAG_EINTR       = 1 << 7,
 	// Do not call termkey_start() in constructor
-	TERMO_FLAG_NOSTART     = 1 << 8
+	TERMO_FLAG_NOSTART     = 1 << 8,
+	// Leave multibyte empty until termo_key_multibyte() is called
+	TERMO_FLAG_LAZY_MULTIBYTE = 1 << 9,
+	// Return runs of printable characters as TERMO_TYPE_TEXT
+	TERMO_FLAG_TEXT        = 1 << 10,
+	// Enable bracketed paste, returning pastes as TERMO_TYPE_PASTE_*
+	TERMO_FLAG_PASTE       = 1 << 11,
+	// Decode through a single automaton merged from all the drivers
+	TERMO_FLAG_AUTOMATON   = 1 << 12,
+	// Take Escape ending a read, with nothing more pending, as the key itself
+	TERMO_FLAG_READBOUNDARY = 1 << 13,
+	// Let termo_waitkey() wait for the rest of sequences in read() via VTIME
+	TERMO_FLAG_VTIME       = 1 << 14
 };
 
 enum
@@ -225,15 +293,23 @@ void termo_set_flags (termo_t *tk, int newflags);
 int termo_get_waittime (termo_t *tk);
 void termo_set_waittime (termo_t *tk, int msec);
 
+int termo_get_waittime_max (termo_t *tk);
+void termo_set_waittime_max (termo_t *tk, int msec);
+int termo_probe_waittime (termo_t *tk);
+
 int termo_get_canonflags (termo_t *tk);
 void termo_set_canonflags (termo_t *tk, int flags);
 
 size_t termo_get_buffer_size (termo_t *tk);
 int termo_set_buffer_size (termo_t *tk, size_t size);
 
+size_t termo_get_buffer_max_size (termo_t *tk);
+void termo_set_buffer_max_size (termo_t *tk, size_t size);
+
 size_t termo_get_buffer_remaining (termo_t *tk);
 
 void termo_canonicalise (termo_t *tk, termo_key_t *key);
+const char *termo_key_multibyte (termo_t *tk, termo_key_t *key);
 
 termo_mouse_proto_t termo_get_mouse_proto (termo_t *tk);
 int termo_set_mouse_proto (termo_t *tk, termo_mouse_proto_t proto);
@@ -242,11 +318,19 @@ termo_mouse_proto_t termo_guess_mouse_proto (termo_t *tk);
 termo_mouse_tracking_t termo_get_mouse_tracking_mode (termo_t *tk);
 int termo_set_mouse_tracking_mode (termo_t *tk, termo_mouse_tracking_t mode);
 
+int termo_get_keyboard_flags (termo_t *tk);
+int termo_set_keyboard_flags (termo_t *tk, int flags);
+int termo_get_reported_keyboard_flags (termo_t *tk);
+
 termo_result_t termo_getkey (termo_t *tk, termo_key_t *key);
+termo_result_t termo_getkeys (termo_t *tk,
+	termo_key_t *keys, size_t max, size_t *nkeys);
 termo_result_t termo_getkey_force (termo_t *tk, termo_key_t *key);
 termo_result_t termo_waitkey (termo_t *tk, termo_key_t *key);
 
 termo_result_t termo_advisereadable (termo_t *tk);
+termo_result_t termo_advisereadable_drain (termo_t *tk,
+	size_t budget, size_t *nbytes);
 
 size_t termo_push_bytes (termo_t *tk, const char *bytes, size_t len);
 
@@ -267,6 +351,12 @@ termo_result_t termo_interpret_modereport (termo_t *tk,
 	const termo_key_t *key, int *initial, int *mode, int *value);
 termo_result_t termo_interpret_csi (termo_t *tk,
 	const termo_key_t *key, long args[], size_t *nargs, unsigned long *cmd);
+termo_result_t termo_interpret_csi_info (termo_t *tk,
+	const termo_key_t *key, const termo_csi_info_t **info);
+termo_result_t termo_interpret_text (termo_t *tk,
+	const termo_key_t *key, const char **text, size_t *len, size_t *count);
+termo_result_t termo_interpret_paste (termo_t *tk,
+	const termo_key_t *key, const char **data, size_t *len);
 
 typedef enum termo_format termo_format_t;
 enum termo_format
@@ -308,6 +398,7 @@ size_t termo_strfkey_utf8 (termo_t *tk, char *buffer, size_t len,
 const char *termo_strpkey_utf8 (termo_t *tk, const char *str,
 	termo_key_t *key, termo_format_t format);
 
+// Compares keys as they would be written, ignoring the event field
 int termo_keycmp (termo_t *tk,
 	const termo_key_t *key1, const termo_key_t *key2);
 
@@ -8,9 +8,10 @@ main (int argc, char *argv[])
 	(void) argc;
 	(void) argv;
 
-	termo_t *tk;
+	termo_t *tk, *tk2;
+	termo_key_t key;
 
-	plan_tests (6);
+	plan_tests (10);
 
 	tk = termo_new_abstract ("vt100", NULL, 0);
 	ok (!!tk, "termo_new_abstract");
@@ -25,8 +26,22 @@ main (int argc, char *argv[])
 	ok (termo_is_started (tk),
 		"termo_is_started true after termo_start()");
 
+	// Instances for the same terminal share the loaded terminfo entry
+	tk2 = termo_new_abstract ("vt100", NULL, 0);
+	ok (!!tk2, "termo_new_abstract for the same terminal");
+
 	termo_destroy (tk);
 
 	ok (1, "termo_free");
+
+	termo_push_bytes (tk2, "\eOA", 3);
+	is_int (termo_getkey (tk2, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY after the other instance is freed");
+	is_int (key.code.sym, TERMO_SYM_UP, "key.code.sym from terminfo");
+
+	termo_destroy (tk2);
+	tk = termo_new_abstract ("vt100", NULL, 0);
+	ok (!!tk, "termo_new_abstract after all instances are freed");
+	termo_destroy (tk);
 	return exit_status ();
 }
@@ -10,7 +10,7 @@ main (int argc, char *argv[])
 	termo_t *tk;
 	termo_key_t key;
 
-	plan_tests (42);
+	plan_tests (58);
 
 	tk = termo_new_abstract ("vt100", NULL, 0);
 
@@ -119,6 +119,43 @@ main (int argc, char *argv[])
 	is_int (key.modifiers, TERMO_KEYMOD_ALT,
 		"key.modifiers after three Escapes");
 
+	// Incomplete input is interpreted as it stands once forced
+
+	termo_push_bytes (tk, "\033O", 2);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN after partial SS3");
+	is_int (key.code.codepoint, 'O', "key.code.codepoint after partial SS3");
+	is_int (key.modifiers, TERMO_KEYMOD_ALT, "key.modifiers after partial SS3");
+
+	is_int (termo_getkey_force (tk, &key), TERMO_RES_KEY,
+		"getkey_force yields RES_KEY after partial SS3");
+	is_int (key.type, TERMO_TYPE_KEY, "key.type after forced partial SS3");
+	is_int (key.code.codepoint, 'O',
+		"key.code.codepoint after forced partial SS3");
+	is_int (key.modifiers, TERMO_KEYMOD_ALT,
+		"key.modifiers after forced partial SS3");
+	is_int (termo_get_buffer_remaining (tk), 256,
+		"buffer free 256 after forced partial SS3");
+
+	termo_push_bytes (tk, "\033[", 2);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN after partial CSI");
+	termo_push_bytes (tk, "D", 1);
+	is_int (termo_getkey_force (tk, &key), TERMO_RES_KEY,
+		"getkey_force yields RES_KEY after CSI completion");
+	is_int (key.type, TERMO_TYPE_KEYSYM, "key.type after CSI completion");
+	is_int (key.code.sym, TERMO_SYM_LEFT, "key.code.sym after CSI completion");
+
+	termo_push_bytes (tk, "\033", 1);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN after Escape");
+	termo_stop (tk);
+	is_int (termo_getkey_force (tk, &key), TERMO_RES_ERROR,
+		"getkey_force yields RES_ERROR once stopped");
+	termo_start (tk);
+	is_int (termo_getkey_force (tk, &key), TERMO_RES_KEY,
+		"getkey_force yields RES_KEY once started again");
+
 	termo_destroy (tk);
 
 	return exit_status ();
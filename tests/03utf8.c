@@ -10,7 +10,7 @@ main (int argc, char *argv[])
 	termo_t *tk;
 	termo_key_t key;
 
-	plan_tests (33 /* 57 */);
+	plan_tests (45 /* 57 */);
 
 	tk = termo_new_abstract ("vt100", "UTF-8", 0);
 
@@ -186,6 +186,44 @@ main (int argc, char *argv[])
 	is_int (key.code.codepoint, 0x10000,
 		"key.code.codepoint UTF-8 4 partial");
 
+	// Invalid sequences are skipped byte by byte, as with iconv()
+
+	termo_push_bytes (tk, "\xC0\x80", 2);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY UTF-8 overlong");
+	is_int (key.code.codepoint, '?', "key.code.codepoint UTF-8 overlong");
+	termo_getkey (tk, &key);
+
+	termo_push_bytes (tk, "\xED\xA0\x80", 3);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY UTF-8 surrogate");
+	is_int (key.code.codepoint, '?', "key.code.codepoint UTF-8 surrogate");
+	termo_getkey (tk, &key);
+	termo_getkey (tk, &key);
+
+	termo_push_bytes (tk, "\xC3\xA9", 2);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY UTF-8 2 multibyte");
+	is_str (key.multibyte, "\xC3\xA9", "key.multibyte UTF-8 2 multibyte");
+
+	// Forcing a truncated sequence must not make up a character from it
+
+	termo_push_bytes (tk, "\xC3", 1);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN UTF-8 truncated");
+	is_int (termo_getkey_force (tk, &key), TERMO_RES_KEY,
+		"getkey_force yields RES_KEY UTF-8 truncated");
+	is_int (key.code.codepoint, '?', "key.code.codepoint UTF-8 truncated");
+	is_int (key.modifiers, 0, "key.modifiers UTF-8 truncated");
+
+	termo_push_bytes (tk, "ab\xE2\x82", 4);
+	termo_getkey (tk, &key);
+	termo_getkey (tk, &key);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN UTF-8 3 truncated");
+	termo_getkey_force (tk, &key);
+	is_int (key.code.codepoint, '?', "key.code.codepoint UTF-8 3 truncated");
+
 	termo_destroy (tk);
 	return exit_status ();
 }
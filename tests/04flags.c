@@ -11,7 +11,7 @@ main (int argc, char *argv[])
 	termo_t *tk;
 	termo_key_t key;
 
-	plan_tests (8);
+	plan_tests (12);
 
 	tk = termo_new_abstract ("vt100", NULL, 0);
 
@@ -38,6 +38,17 @@ main (int argc, char *argv[])
 	is_int (key.modifiers, 0,
 		"key.modifiers after space with FLAG_SPACESYMBOL");
 
+	termo_set_flags (tk, TERMO_FLAG_LAZY_MULTIBYTE);
+
+	termo_push_bytes (tk, "x", 1);
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY after x");
+	is_int (key.code.codepoint, 'x', "key.code.codepoint after x");
+	is_str (key.multibyte, "", "key.multibyte with FLAG_LAZY_MULTIBYTE");
+	is_str (termo_key_multibyte (tk, &key), "x",
+		"termo_key_multibyte with FLAG_LAZY_MULTIBYTE");
+
 	termo_destroy (tk);
 	return exit_status ();
 }
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <unistd.h>
+#include <string.h>
 #include "../termo.h"
 #include "taplib.h"
 
@@ -16,7 +17,7 @@ main (int argc, char *argv[])
 	termo_t *tk;
 	termo_key_t key;
 
-	plan_tests (21);
+	plan_tests (25);
 
 	// We'll need a real filehandle we can write/read.  pipe() can make us one
 	pipe (fd);
@@ -79,6 +80,28 @@ main (int argc, char *argv[])
 	is_int (termo_get_buffer_remaining (tk), 256,
 		"buffer free 256 after completion");
 
+	// The adaptive mode
+	termo_set_buffer_max_size (tk, 4096);
+
+	char large[1000];
+	memset (large, 'y', sizeof large);
+	write (fd[1], large, sizeof large);
+
+	is_int (termo_advisereadable (tk), TERMO_RES_AGAIN,
+		"advisereadable yields RES_AGAIN after a large write");
+	is_int (termo_get_buffer_remaining (tk), 24,
+		"advisereadable reads everything at once");
+
+	while (termo_getkey (tk, &key) == TERMO_RES_KEY)
+		;
+
+	write (fd[1], "h", 1);
+	termo_advisereadable (tk);
+	is_int (termo_get_buffer_size (tk), 256,
+		"buffer shrinks back when idle");
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY after shrinking");
+
 	termo_stop (tk);
 
 	is_int (termo_getkey (tk, &key), TERMO_RES_ERROR,
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include "../termo.h"
 #include "taplib.h"
 
@@ -11,7 +12,7 @@ main (int argc, char *argv[])
 	termo_t *tk;
 	termo_key_t key;
 
-	plan_tests (9);
+	plan_tests (19);
 
 	tk = termo_new_abstract ("vt100", NULL, 0);
 
@@ -37,6 +38,55 @@ main (int argc, char *argv[])
 	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
 		"buffered key still useable after resize");
 
+	termo_destroy (tk);
+
+	// Make the data wrap around the end of the ring buffer
+	tk = termo_new_abstract ("vt100", "UTF-8", 0);
+
+	char filler[252];
+	memset (filler, 'x', sizeof filler);
+	termo_push_bytes (tk, filler, sizeof filler);
+	for (size_t i = 1; i < sizeof filler; i++)
+		termo_getkey (tk, &key);
+
+	is_int (termo_push_bytes (tk, "\033OA\xC3\xA9", 5), 5,
+		"push_bytes returns 5 across the end of the buffer");
+	is_int (termo_get_buffer_remaining (tk), 250,
+		"buffer free 250 after wrapping around");
+
+	termo_getkey (tk, &key);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for Up across the end of the buffer");
+	is_int (key.code.sym, TERMO_SYM_UP,
+		"key.code.sym for Up across the end of the buffer");
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for multibyte across the end of the buffer");
+	is_int (key.code.codepoint, 0xE9,
+		"key.code.codepoint for multibyte across the end of the buffer");
+
+	termo_destroy (tk);
+
+	// The adaptive mode
+	tk = termo_new_abstract ("vt100", NULL, 0);
+	termo_set_buffer_max_size (tk, 4096);
+
+	char large[1000];
+	memset (large, 'y', sizeof large);
+	is_int (termo_push_bytes (tk, large, sizeof large), 1000,
+		"push_bytes takes everything in the adaptive mode");
+	is_int (termo_get_buffer_size (tk), 1024,
+		"buffer size grows to 1024");
+
+	termo_push_bytes (tk, large, sizeof large);
+	termo_push_bytes (tk, large, sizeof large);
+	termo_push_bytes (tk, large, sizeof large);
+	termo_push_bytes (tk, large, sizeof large);
+	is_int (termo_get_buffer_size (tk), 4096,
+		"buffer size stops growing at the ceiling");
+	is_int (termo_get_buffer_remaining (tk), 0,
+		"buffer is full at the ceiling");
+
 	termo_destroy (tk);
 	return exit_status ();
 }
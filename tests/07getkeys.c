@@ -0,0 +1,84 @@
+#include "../termo.h"
+#include "taplib.h"
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	termo_t *tk;
+	termo_key_t keys[32];
+	size_t n;
+
+	plan_tests (30);
+
+	tk = termo_new_abstract ("vt100", NULL, 0);
+
+	is_int (termo_getkeys (tk, keys, 4, &n), TERMO_RES_NONE,
+		"getkeys yields RES_NONE when empty");
+	is_int (n, 0, "no keys when empty");
+
+	termo_push_bytes (tk, "ab\033OA", 5);
+
+	is_int (termo_getkeys (tk, keys, 4, &n), TERMO_RES_NONE,
+		"getkeys yields RES_NONE after draining the buffer");
+	is_int (n, 3, "three keys after a, b, Up");
+
+	is_int (keys[0].type, TERMO_TYPE_KEY, "keys[0].type after a");
+	is_int (keys[0].code.codepoint, 'a', "keys[0].code.codepoint after a");
+	is_str (keys[0].multibyte, "a", "keys[0].multibyte after a");
+	is_int (keys[1].code.codepoint, 'b', "keys[1].code.codepoint after b");
+	is_int (keys[2].type, TERMO_TYPE_KEYSYM, "keys[2].type after Up");
+	is_int (keys[2].code.sym, TERMO_SYM_UP, "keys[2].code.sym after Up");
+
+	is_int (termo_get_buffer_remaining (tk), 256,
+		"buffer free 256 after getkeys");
+
+	termo_push_bytes (tk, "abcdef", 6);
+
+	is_int (termo_getkeys (tk, keys, 4, &n), TERMO_RES_KEY,
+		"getkeys yields RES_KEY when the array is full");
+	is_int (n, 4, "four keys when the array is full");
+	is_int (keys[3].code.codepoint, 'd', "keys[3].code.codepoint after d");
+
+	is_int (termo_getkeys (tk, keys, 4, &n), TERMO_RES_NONE,
+		"getkeys yields RES_NONE for the rest");
+	is_int (n, 2, "two keys for the rest");
+
+	termo_push_bytes (tk, "x\033O", 3);
+
+	is_int (termo_getkeys (tk, keys, 4, &n), TERMO_RES_AGAIN,
+		"getkeys yields RES_AGAIN after partial write");
+	is_int (n, 1, "one key before the partial sequence");
+	is_int (keys[0].code.codepoint, 'x', "keys[0].code.codepoint after x");
+	is_int (termo_get_buffer_remaining (tk), 254,
+		"partial sequence is left in the buffer");
+
+	termo_push_bytes (tk, "C", 1);
+
+	is_int (termo_getkeys (tk, keys, 4, &n), TERMO_RES_NONE,
+		"getkeys yields RES_NONE after Right completion");
+	is_int (n, 1, "one key after Right completion");
+	is_int (keys[0].code.sym, TERMO_SYM_RIGHT, "keys[0].code.sym after Right");
+
+	// Long enough for plain text runs to get scanned in vectors
+	termo_push_bytes (tk, "0123456789abcdefghijklmnopqrstuv\033OAw", 36);
+
+	is_int (termo_getkeys (tk, keys, 32, &n), TERMO_RES_KEY,
+		"getkeys yields RES_KEY for a long run of text");
+	is_int (keys[31].code.codepoint, 'v', "keys[31].code.codepoint after v");
+	is_int (termo_getkeys (tk, keys, 32, &n), TERMO_RES_NONE,
+		"getkeys yields RES_NONE after the run of text");
+	is_int (keys[0].code.sym, TERMO_SYM_UP, "keys[0].code.sym after the run");
+
+	termo_push_bytes (tk, "\e[5;25vy", 8);
+
+	is_int (termo_getkeys (tk, keys, 4, &n), TERMO_RES_KEY,
+		"getkeys yields RES_KEY after unknown CSI");
+	is_int (n, 1, "getkeys stops after unknown CSI");
+	is_int (keys[0].type, TERMO_TYPE_UNKNOWN_CSI, "keys[0].type for unknown CSI");
+
+	termo_destroy (tk);
+	return exit_status ();
+}
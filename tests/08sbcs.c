@@ -0,0 +1,51 @@
+#include "../termo.h"
+#include "taplib.h"
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	termo_t *tk;
+	termo_key_t key;
+	char buffer[16];
+
+	plan_tests (10);
+
+	tk = termo_new_abstract ("vt100", "ISO-8859-2", 0);
+
+	termo_push_bytes (tk, "a\xB9", 2);
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY ISO-8859-2 ASCII");
+	is_int (key.code.codepoint, 'a', "key.code.codepoint ISO-8859-2 ASCII");
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY ISO-8859-2 high");
+	is_int (key.code.codepoint, 0x0161, "key.code.codepoint ISO-8859-2 high");
+	is_str (key.multibyte, "\xB9", "key.multibyte ISO-8859-2 high");
+
+	is_str (termo_strpkey (tk, "\xE8", &key, 0), "",
+		"strpkey consumes ISO-8859-2 high");
+	is_int (key.code.codepoint, 0x010D, "key.code.codepoint from strpkey");
+
+	key.type = TERMO_TYPE_KEY;
+	key.modifiers = 0;
+	key.code.codepoint = 0x4E00;
+	key.multibyte[0] = 0;
+	termo_strfkey (tk, buffer, sizeof buffer, &key, 0);
+	is_str (buffer, "?", "strfkey of an unrepresentable character");
+
+	termo_destroy (tk);
+
+	tk = termo_new_abstract ("vt100", "KOI8-R", 0);
+
+	termo_push_bytes (tk, "\xC1", 1);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY KOI8-R");
+	is_int (key.code.codepoint, 0x0430, "key.code.codepoint KOI8-R");
+
+	termo_destroy (tk);
+	return exit_status ();
+}
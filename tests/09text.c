@@ -0,0 +1,63 @@
+#include <string.h>
+#include "../termo.h"
+#include "taplib.h"
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	termo_t *tk;
+	termo_key_t key;
+	const char *text;
+	size_t len, count;
+
+	plan_tests (19);
+
+	tk = termo_new_abstract ("vt100", "UTF-8", TERMO_FLAG_TEXT);
+
+	termo_push_bytes (tk, "h\xC3\xA9llo\x01w", 8);
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for text");
+	is_int (key.type, TERMO_TYPE_TEXT, "key.type for text");
+	is_int (termo_interpret_text (tk, &key, &text, &len, &count),
+		TERMO_RES_KEY, "interpret_text yields RES_KEY");
+	is_int (len, 6, "text length in bytes");
+	is_int (count, 5, "text length in characters");
+	ok (!strncmp (text, "h\xC3\xA9llo", len), "text contents");
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for C-a");
+	is_int (key.type, TERMO_TYPE_KEY, "key.type for C-a");
+	is_int (key.modifiers, TERMO_KEYMOD_CTRL, "key.modifiers for C-a");
+	is_int (termo_interpret_text (tk, &key, &text, &len, &count),
+		TERMO_RES_NONE, "interpret_text yields RES_NONE for C-a");
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for a single character");
+	is_int (key.type, TERMO_TYPE_TEXT, "key.type for a single character");
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_NONE,
+		"getkey yields RES_NONE after text");
+	is_int (termo_get_buffer_remaining (tk), 256,
+		"buffer free 256 after text");
+
+	termo_push_bytes (tk, "ab\033OAc\xC3", 7);
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for text before Up");
+	is_int (key.code.text.len, 2, "text before Up is cut short");
+
+	termo_getkey (tk, &key);
+	is_int (key.code.sym, TERMO_SYM_UP, "key.code.sym after text");
+
+	termo_getkey (tk, &key);
+	is_int (key.code.text.len, 1, "partial characters aren't part of text");
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN for the partial character");
+
+	termo_destroy (tk);
+	return exit_status ();
+}
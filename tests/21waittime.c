@@ -0,0 +1,102 @@
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "../termo.h"
+#include "taplib.h"
+
+static void
+sleep_msec (long msec)
+{
+	struct timespec ts = { msec / 1000, msec % 1000 * 1000000 };
+	nanosleep (&ts, NULL);
+}
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	termo_t *tk;
+	termo_key_t key;
+
+	plan_tests (17);
+
+	tk = termo_new_abstract ("vt100", NULL, 0);
+
+	is_int (termo_get_waittime (tk), 50, "waittime initially 50");
+	is_int (termo_get_waittime_max (tk), 0, "adaptive mode initially off");
+
+	termo_set_waittime_max (tk, 200);
+	is_int (termo_get_waittime (tk), 50,
+		"waittime unchanged before any sequences arrive");
+
+	termo_push_bytes (tk, "\e[", 2);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN for a partial sequence");
+
+	sleep_msec (20);
+	termo_push_bytes (tk, "A", 1);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY once the sequence is complete");
+	is_int (key.code.sym, TERMO_SYM_UP, "key.code.sym for Up");
+
+	int waittime = termo_get_waittime (tk);
+	ok (waittime >= 30 && waittime <= 200,
+		"waittime follows the observed delay");
+
+	termo_push_bytes (tk, "\e[", 2);
+	termo_getkey (tk, &key);
+	sleep_msec (120);
+	is_int (termo_getkey_force (tk, &key), TERMO_RES_KEY,
+		"getkey_force yields RES_KEY after a timeout");
+	is_int (termo_get_waittime (tk), waittime,
+		"timed out sequences don't affect waittime");
+
+	termo_set_waittime_max (tk, 25);
+	is_int (termo_get_waittime (tk), 25, "waittime clamped to the maximum");
+
+	termo_set_waittime_max (tk, 0);
+	is_int (termo_get_waittime (tk), 50,
+		"waittime restored when the adaptive mode is off");
+
+	ok (!termo_probe_waittime (tk), "cannot probe without a file descriptor");
+
+	termo_destroy (tk);
+
+	// Measure the round-trip time to a fake terminal
+	int fd[2];
+	socketpair (AF_UNIX, SOCK_STREAM, 0, fd);
+
+	// Sanitise this just in case
+	putenv ("TERM=vt100");
+
+	tk = termo_new (fd[0], NULL, TERMO_FLAG_NOTERMIOS);
+	termo_set_waittime (tk, 5);
+
+	ok (!termo_probe_waittime (tk), "cannot probe outside the adaptive mode");
+
+	termo_set_waittime_max (tk, 1000);
+	ok (termo_probe_waittime (tk), "probe_waittime succeeds");
+
+	char request[16] = "";
+	read (fd[1], request, sizeof request - 1);
+	is_str (request, "\e[?6n", "probe sends a position request");
+
+	sleep_msec (30);
+	write (fd[1], "\e[?5;10R", 8);
+	termo_advisereadable (tk);
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for the position report");
+	ok (key.type == TERMO_TYPE_POSITION && termo_get_waittime (tk) >= 40,
+		"waittime follows the round-trip time");
+
+	termo_destroy (tk);
+
+	return exit_status ();
+}
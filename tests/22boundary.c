@@ -0,0 +1,104 @@
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "../termo.h"
+#include "taplib.h"
+
+static double
+now (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Sends a lone Escape through the pseudoterminal, returns how long it took
+// termo_waitkey() to report it
+static double
+time_escape (termo_t *tk, int master, termo_key_t *key)
+{
+	double start = now ();
+	write (master, "\e", 1);
+	if (termo_waitkey (tk, key) != TERMO_RES_KEY)
+		return -1;
+	return now () - start;
+}
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	termo_t *tk;
+	termo_key_t key;
+
+	plan_tests (14);
+
+	tk = termo_new_abstract ("vt100", NULL, TERMO_FLAG_READBOUNDARY);
+
+	termo_push_bytes (tk, "\e", 1);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for Escape ending the input");
+	is_int (key.code.sym, TERMO_SYM_ESCAPE, "key.code.sym for Escape");
+
+	termo_push_bytes (tk, "a\e", 2);
+	termo_getkey (tk, &key);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for Escape following text");
+	is_int (key.code.sym, TERMO_SYM_ESCAPE, "key.code.sym for Escape");
+
+	termo_push_bytes (tk, "\e[", 2);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN for an incomplete sequence");
+	termo_push_bytes (tk, "A", 1);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY once the sequence is complete");
+	is_int (key.code.sym, TERMO_SYM_UP, "key.code.sym for Up");
+
+	termo_set_flags (tk, termo_get_flags (tk) & ~TERMO_FLAG_READBOUNDARY);
+	termo_push_bytes (tk, "\e", 1);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN for Escape without the flag");
+
+	termo_destroy (tk);
+
+	// Measure the difference on a pseudoterminal
+	int master = posix_openpt (O_RDWR | O_NOCTTY);
+	ok (master != -1 && !grantpt (master) && !unlockpt (master),
+		"pseudoterminal created");
+	int slave = open (ptsname (master), O_RDWR | O_NOCTTY);
+
+	// Sanitise this just in case
+	putenv ("TERM=vt100");
+
+	tk = termo_new (slave, NULL, TERMO_FLAG_READBOUNDARY);
+	termo_set_waittime (tk, 200);
+
+	double latency = time_escape (tk, master, &key);
+	is_int (key.code.sym, TERMO_SYM_ESCAPE, "waitkey yields Escape");
+	ok (latency >= 0 && latency < 0.1, "Escape reported without waiting");
+
+	termo_set_flags (tk, termo_get_flags (tk) & ~TERMO_FLAG_READBOUNDARY);
+	double delayed = time_escape (tk, master, &key);
+	is_int (key.code.sym, TERMO_SYM_ESCAPE, "waitkey yields Escape");
+	ok (delayed >= 0.15, "Escape reported after waittime without the flag");
+
+	printf ("# Escape latency %.3f ms with the flag, %.3f ms without\n",
+		latency * 1000, delayed * 1000);
+
+	write (master, "\e[A", 3);
+	termo_set_flags (tk, termo_get_flags (tk) | TERMO_FLAG_READBOUNDARY);
+	termo_waitkey (tk, &key);
+	is_int (key.code.sym, TERMO_SYM_UP, "whole sequences unaffected");
+
+	termo_destroy (tk);
+	close (slave);
+	close (master);
+
+	return exit_status ();
+}
@@ -0,0 +1,106 @@
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../termo.h"
+#include "taplib.h"
+
+// Writes `data' to `fd' from another process after `msec' milliseconds
+static pid_t
+write_later (int fd, const char *data, long msec)
+{
+	pid_t pid = fork ();
+	if (pid == 0)
+	{
+		struct timespec ts = { msec / 1000, msec % 1000 * 1000000 };
+		nanosleep (&ts, NULL);
+		write (fd, data, strlen (data));
+		_exit (0);
+	}
+	return pid;
+}
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	termo_t *tk;
+	termo_key_t key;
+	struct termios termios;
+
+	plan_tests (18);
+
+	int master = posix_openpt (O_RDWR | O_NOCTTY);
+	ok (master != -1 && !grantpt (master) && !unlockpt (master),
+		"pseudoterminal created");
+	int slave = open (ptsname (master), O_RDWR | O_NOCTTY);
+
+	// Sanitise this just in case
+	putenv ("TERM=vt100");
+
+	tk = termo_new (slave, NULL, TERMO_FLAG_VTIME);
+
+	tcgetattr (slave, &termios);
+	is_int (termios.c_cc[VMIN], 1, "VMIN is 1 while idle");
+	is_int (termios.c_cc[VTIME], 0, "VTIME is 0 while idle");
+
+	write (master, "a", 1);
+	termo_set_waittime (tk, 250);
+	is_int (termo_waitkey (tk, &key), TERMO_RES_KEY, "waitkey yields RES_KEY");
+	is_int (key.code.codepoint, 'a', "key.code.codepoint for a");
+
+	pid_t pid = write_later (master, "A", 100);
+	write (master, "\e[", 2);
+	is_int (termo_waitkey (tk, &key), TERMO_RES_KEY,
+		"waitkey yields RES_KEY for a sequence arriving in pieces");
+	is_int (key.code.sym, TERMO_SYM_UP, "key.code.sym for Up");
+	waitpid (pid, NULL, 0);
+
+	tcgetattr (slave, &termios);
+	is_int (termios.c_cc[VMIN], 0, "VMIN is 0 after an incomplete sequence");
+	is_int (termios.c_cc[VTIME], 3, "VTIME follows the waittime");
+
+	write (master, "\e", 1);
+	is_int (termo_waitkey (tk, &key), TERMO_RES_KEY,
+		"waitkey yields RES_KEY for a lone Escape");
+	is_int (key.code.sym, TERMO_SYM_ESCAPE, "key.code.sym for Escape");
+
+	// Wait without any input for longer than VTIME
+	pid = write_later (master, "x", 500);
+	is_int (termo_waitkey (tk, &key), TERMO_RES_KEY,
+		"waitkey yields RES_KEY after a while without input");
+	is_int (key.code.codepoint, 'x', "key.code.codepoint for x");
+	waitpid (pid, NULL, 0);
+
+	tcgetattr (slave, &termios);
+	is_int (termios.c_cc[VMIN], 1, "VMIN is 1 again once idle");
+
+	termo_set_flags (tk, termo_get_flags (tk) & ~TERMO_FLAG_VTIME);
+	pid = write_later (master, "B", 100);
+	write (master, "\e[", 2);
+	is_int (termo_waitkey (tk, &key), TERMO_RES_KEY,
+		"waitkey yields RES_KEY without the flag");
+	waitpid (pid, NULL, 0);
+
+	tcgetattr (slave, &termios);
+	is_int (termios.c_cc[VMIN], 1, "VMIN stays 1 without the flag");
+	is_int (termios.c_cc[VTIME], 0, "VTIME stays 0 without the flag");
+
+	termo_set_flags (tk, termo_get_flags (tk) | TERMO_FLAG_VTIME);
+	close (master);
+	is_int (termo_waitkey (tk, &key), TERMO_RES_EOF,
+		"waitkey yields RES_EOF after hangup");
+
+	termo_destroy (tk);
+	close (slave);
+
+	return exit_status ();
+}
@@ -0,0 +1,85 @@
+#define _XOPEN_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "../termo.h"
+#include "taplib.h"
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	int fd[2];
+	termo_t *tk;
+	termo_key_t key;
+	size_t nbytes;
+	char input[1000];
+
+	plan_tests (16);
+
+	// We'll need a real filehandle we can write/read.  pipe() can make us one
+	pipe (fd);
+	memset (input, 'a', sizeof input);
+
+	// Sanitise this just in case
+	putenv ("TERM=vt100");
+
+	tk = termo_new (fd[0], NULL, TERMO_FLAG_NOTERMIOS);
+
+	write (fd[1], input, sizeof input);
+	is_int (termo_advisereadable_drain (tk, 0, &nbytes), TERMO_RES_AGAIN,
+		"advisereadable_drain yields RES_AGAIN");
+	is_int (nbytes, 256, "without growth, reading stops with a full buffer");
+
+	while (termo_getkey (tk, &key) == TERMO_RES_KEY)
+		;
+
+	termo_set_buffer_max_size (tk, 4096);
+	termo_advisereadable_drain (tk, 100, &nbytes);
+	is_int (nbytes, 100, "reading stops once the budget is spent");
+	is_int (termo_get_buffer_remaining (tk), 156,
+		"buffer free 156 after reading 100 bytes");
+
+	termo_advisereadable_drain (tk, 0, &nbytes);
+	is_int (nbytes, 644, "reading continues until there is no more input");
+	is_int (termo_get_buffer_size (tk), 1024, "buffer grown to fit the input");
+
+	int keys = 0;
+	while (termo_getkey (tk, &key) == TERMO_RES_KEY)
+		keys++;
+	is_int (keys, 744, "getkey yields all the keys read");
+
+	write (fd[1], input, sizeof input);
+	write (fd[1], input, sizeof input);
+	write (fd[1], "\e[A", 3);
+	termo_advisereadable_drain (tk, 0, &nbytes);
+	is_int (nbytes, 2003, "text and a sequence read at once");
+
+	keys = 0;
+	while (termo_getkey (tk, &key) == TERMO_RES_KEY && key.type == TERMO_TYPE_KEY)
+		keys++;
+	is_int (keys, 2000, "getkey yields all the text");
+	is_int (key.code.sym, TERMO_SYM_UP, "getkey yields Up after the text");
+	is_int (termo_get_buffer_size (tk), 2048, "buffer grown to fit the input");
+
+	write (fd[1], "b", 1);
+	termo_getkey (tk, &key);
+	termo_advisereadable_drain (tk, 0, &nbytes);
+	is_int (termo_get_buffer_size (tk), 256, "buffer shrunk back when idle");
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY, "getkey yields RES_KEY");
+	is_int (key.code.codepoint, 'b', "key.code.codepoint for b");
+
+	close (fd[1]);
+
+	is_int (termo_advisereadable_drain (tk, 0, &nbytes), TERMO_RES_NONE,
+		"advisereadable_drain yields RES_NONE at the end of input");
+	is_int (nbytes, 0, "nothing read at the end of input");
+
+	termo_destroy (tk);
+
+	return exit_status ();
+}
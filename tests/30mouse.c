@@ -14,7 +14,7 @@ main (int argc, char *argv[])
 	char buffer[32];
 	size_t len;
 
-	plan_tests (60);
+	plan_tests (62);
 
 	tk = termo_new_abstract ("vt100", NULL, 0);
 
@@ -171,6 +171,17 @@ main (int argc, char *argv[])
 	is_int (line, 299, "mouse line for press SGR wide");
 	is_int (col, 499, "mouse column for press SGR wide");
 
+	// An incomplete UTF-8 coordinate, but a complete event otherwise
+	termo_set_mouse_proto (tk, TERMO_MOUSE_PROTO_UTF8);
+	termo_push_bytes (tk, "\e[M !\xc2", 6);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN for a partial 1005 mouse event");
+
+	termo_set_mouse_proto (tk, TERMO_MOUSE_PROTO_XTERM);
+	termo_getkey_force (tk, &key);
+	is_int (key.type, TERMO_TYPE_MOUSE,
+		"changing the protocol affects the forced interpretation");
+
 	termo_destroy (tk);
 
 	return exit_status ();
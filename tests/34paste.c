@@ -0,0 +1,137 @@
+#define _XOPEN_SOURCE 600
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include "../termo.h"
+#include "taplib.h"
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	termo_t *tk;
+	termo_key_t key;
+	const char *data;
+	size_t len;
+
+	plan_tests (26);
+
+	tk = termo_new_abstract ("vt100", "UTF-8", 0);
+
+	termo_push_bytes (tk, "\e[200~", 6);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for paste start without the flag");
+	is_int (key.type, TERMO_TYPE_UNKNOWN_CSI,
+		"key.type for paste start without the flag");
+
+	termo_destroy (tk);
+
+	tk = termo_new_abstract ("vt100", "UTF-8", TERMO_FLAG_PASTE);
+
+	termo_push_bytes (tk, "\e[200~a\e[Ab", 11);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for paste start");
+	is_int (key.type, TERMO_TYPE_PASTE_BEGIN, "key.type for paste start");
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for paste data");
+	is_int (key.type, TERMO_TYPE_PASTE_DATA, "key.type for paste data");
+	is_int (termo_interpret_paste (tk, &key, &data, &len), TERMO_RES_KEY,
+		"interpret_paste yields RES_KEY");
+	is_int (len, 1, "paste data stops at escape");
+	ok (!strncmp (data, "a", len), "paste data contents");
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for pasted escape");
+	is_int (key.type, TERMO_TYPE_PASTE_DATA, "pasted escape is data");
+	termo_interpret_paste (tk, &key, &data, &len);
+	ok (len == 4 && !strncmp (data, "\e[Ab", len), "pasted escape contents");
+
+	termo_push_bytes (tk, "\e[20", 4);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN for partial end marker");
+
+	termo_push_bytes (tk, "1~x", 3);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for paste end");
+	is_int (key.type, TERMO_TYPE_PASTE_END, "key.type for paste end");
+
+	termo_getkey (tk, &key);
+	is_int (key.type, TERMO_TYPE_KEY, "key.type after paste end");
+	is_int (key.code.codepoint, 'x', "key.code.codepoint after paste end");
+
+	// Pastes larger than the buffer must stream through it
+	termo_set_buffer_size (tk, 16);
+	termo_push_bytes (tk, "\e[200~", 6);
+	termo_getkey (tk, &key);
+
+	size_t total = 0, pieces = 0;
+	int ended = 0, overflowed = 0;
+	for (int i = 0; i < 64 && !ended; i++)
+	{
+		if (i < 10 && termo_push_bytes (tk, "0123456789", 10) != 10)
+			overflowed = 1;
+		if (i == 10)
+			termo_push_bytes (tk, "\e[201~", 6);
+
+		while (termo_getkey (tk, &key) == TERMO_RES_KEY)
+		{
+			if (key.type == TERMO_TYPE_PASTE_END)
+				ended = 1;
+			else if (termo_interpret_paste (tk, &key, &data, &len)
+				== TERMO_RES_KEY)
+			{
+				total += len;
+				pieces++;
+			}
+		}
+	}
+	ok (!overflowed, "large paste never overflows the buffer");
+	ok (ended, "large paste is terminated");
+	is_int (total, 100, "large paste data length");
+	ok (pieces > 1, "large paste arrives in pieces");
+
+	termo_destroy (tk);
+
+	// Changing the flag while started must keep the terminal in sync
+	int master = posix_openpt (O_RDWR | O_NOCTTY);
+	ok (master != -1 && !grantpt (master) && !unlockpt (master),
+		"pseudoterminal created");
+	int slave = open (ptsname (master), O_RDWR | O_NOCTTY);
+
+	// Sanitise this just in case
+	putenv ("TERM=vt100");
+
+	tk = termo_new (slave, NULL, TERMO_FLAG_NOTERMIOS);
+	termo_set_flags (tk, termo_get_flags (tk) | TERMO_FLAG_PASTE);
+	termo_set_flags (tk, termo_get_flags (tk) & ~TERMO_FLAG_PASTE);
+	termo_stop (tk);
+
+	// The output may arrive in pieces
+	char buf[256] = "";
+	size_t buflen = 0;
+	struct pollfd pfd = { .fd = master, .events = POLLIN };
+	while (buflen < sizeof buf - 1 && poll (&pfd, 1, 100) > 0)
+	{
+		ssize_t n = read (master, buf + buflen, sizeof buf - 1 - buflen);
+		if (n <= 0)
+			break;
+		buflen += n;
+	}
+
+	const char *p = strstr (buf, "\e[?2004h");
+	ok (p != NULL, "setting the flag enables bracketed paste");
+	p = p ? strstr (p, "\e[?2004l") : NULL;
+	ok (p != NULL, "clearing the flag disables bracketed paste");
+	ok (p && !strstr (p + 1, "\e[?2004"), "stopping doesn't disable it again");
+
+	termo_destroy (tk);
+	close (slave);
+	close (master);
+	return exit_status ();
+}
@@ -0,0 +1,154 @@
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include "../termo.h"
+#include "taplib.h"
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	termo_t *tk;
+	termo_key_t key, released;
+
+	plan_tests (41);
+
+	tk = termo_new_abstract ("vt100", NULL, 0);
+
+	termo_push_bytes (tk, "\e[27u", 5);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for Escape without waiting");
+	is_int (key.type, TERMO_TYPE_KEYSYM, "key.type for Escape");
+	is_int (key.code.sym, TERMO_SYM_ESCAPE, "key.code.sym for Escape");
+	is_int (key.event, TERMO_KEY_PRESS, "key.event for Escape");
+
+	termo_push_bytes (tk, "\e[97;5u", 7);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY, "getkey yields RES_KEY");
+	is_int (key.type, TERMO_TYPE_KEY, "key.type for Ctrl-a");
+	is_int (key.code.codepoint, 'a', "key.code.codepoint for Ctrl-a");
+	is_int (key.modifiers, TERMO_KEYMOD_CTRL, "key.modifiers for Ctrl-a");
+
+	termo_push_bytes (tk, "\e[97;2;65u", 10);
+	termo_getkey (tk, &key);
+	is_int (key.code.codepoint, 'A', "key.code.codepoint for associated text");
+	is_int (key.modifiers, 0, "key.modifiers for associated text");
+
+	termo_push_bytes (tk, "\e[97;65u", 8);
+	termo_getkey (tk, &key);
+	is_int (key.modifiers, 0, "key.modifiers without Caps Lock");
+
+	termo_push_bytes (tk, "\e[57399u", 8);
+	termo_getkey (tk, &key);
+	is_int (key.type, TERMO_TYPE_KEYSYM, "key.type for KP0");
+	is_int (key.code.sym, TERMO_SYM_KP0, "key.code.sym for KP0");
+
+	termo_push_bytes (tk, "\e[57376;3u", 10);
+	termo_getkey (tk, &key);
+	is_int (key.type, TERMO_TYPE_FUNCTION, "key.type for Alt-F13");
+	is_int (key.code.number, 13, "key.code.number for Alt-F13");
+	is_int (key.modifiers, TERMO_KEYMOD_ALT, "key.modifiers for Alt-F13");
+
+	termo_push_bytes (tk, "\e[57358u", 8);
+	termo_getkey (tk, &key);
+	is_int (key.type, TERMO_TYPE_UNKNOWN_CSI, "key.type for Caps Lock");
+
+	termo_push_bytes (tk, "\e[57441;2u", 10);
+	termo_getkey (tk, &key);
+	is_int (key.type, TERMO_TYPE_UNKNOWN_CSI, "key.type for Left Shift");
+
+	termo_push_bytes (tk, "\e[57428u", 8);
+	termo_getkey (tk, &key);
+	is_int (key.type, TERMO_TYPE_UNKNOWN_CSI, "key.type for Media Play");
+
+	termo_push_bytes (tk, "\e[97;1:2u", 9);
+	termo_getkey (tk, &key);
+	is_int (key.code.codepoint, 'a', "key.code.codepoint for repeated a");
+	is_int (key.event, TERMO_KEY_REPEAT, "key.event for repeated a");
+
+	termo_push_bytes (tk, "\e[97;1:3u", 9);
+	termo_getkey (tk, &key);
+	is_int (key.event, TERMO_KEY_RELEASE, "key.event for released a");
+	released = key;
+
+	termo_push_bytes (tk, "a", 1);
+	termo_getkey (tk, &key);
+	is_int (key.event, TERMO_KEY_PRESS, "key.event for plain a");
+	is_int (termo_keycmp (tk, &released, &key), 0,
+		"keycmp ignores the event");
+
+	termo_push_bytes (tk, "\e[1;5:3A", 8);
+	termo_getkey (tk, &key);
+	is_int (key.code.sym, TERMO_SYM_UP, "key.code.sym for released Ctrl-Up");
+	is_int (key.modifiers, TERMO_KEYMOD_CTRL,
+		"key.modifiers for released Ctrl-Up");
+	is_int (key.event, TERMO_KEY_RELEASE, "key.event for released Ctrl-Up");
+
+	termo_push_bytes (tk, "\e[13;1:2~", 9);
+	termo_getkey (tk, &key);
+	is_int (key.code.number, 3, "key.code.number for repeated F3");
+	is_int (key.event, TERMO_KEY_REPEAT, "key.event for repeated F3");
+
+	is_int (termo_get_reported_keyboard_flags (tk), -1,
+		"no keyboard flags reported initially");
+
+	termo_push_bytes (tk, "\e[?1u", 5);
+	termo_getkey (tk, &key);
+	is_int (key.type, TERMO_TYPE_UNKNOWN_CSI, "key.type for the query reply");
+	is_int (termo_get_reported_keyboard_flags (tk), 1,
+		"keyboard flags reported by the terminal");
+
+	termo_destroy (tk);
+
+	// Negotiate the protocol with a pseudoterminal
+	int master = posix_openpt (O_RDWR | O_NOCTTY);
+	ok (master != -1 && !grantpt (master) && !unlockpt (master),
+		"pseudoterminal created");
+	int slave = open (ptsname (master), O_RDWR | O_NOCTTY);
+
+	// Sanitise this just in case
+	putenv ("TERM=vt100");
+
+	tk = termo_new (slave, NULL, TERMO_FLAG_NOTERMIOS | TERMO_FLAG_NOSTART);
+	is_int (termo_get_keyboard_flags (tk), 0, "keyboard flags initially 0");
+
+	termo_set_keyboard_flags (tk, TERMO_KEYBOARD_DISAMBIGUATE);
+	is_int (termo_get_keyboard_flags (tk), TERMO_KEYBOARD_DISAMBIGUATE,
+		"keyboard flags set");
+
+	ok (termo_start (tk), "termo_start succeeds");
+	ok (termo_set_keyboard_flags (tk, TERMO_KEYBOARD_DISAMBIGUATE
+		| TERMO_KEYBOARD_EVENTS), "keyboard flags changed");
+	ok (termo_stop (tk), "termo_stop succeeds");
+
+	// The output may arrive in pieces
+	char buf[256] = "";
+	size_t len = 0;
+	struct pollfd pfd = { .fd = master, .events = POLLIN };
+	while (len < sizeof buf - 1 && poll (&pfd, 1, 100) > 0)
+	{
+		ssize_t n = read (master, buf + len, sizeof buf - 1 - len);
+		if (n <= 0)
+			break;
+		len += n;
+	}
+
+	const char *p = strstr (buf, "\e[>1u\e[?u");
+	ok (p != NULL, "start pushes the flags and queries them");
+	p = p ? strstr (p, "\e[<u\e[>3u\e[?u") : NULL;
+	ok (p != NULL, "changing flags pops and pushes");
+	p = p ? strstr (p + 5, "\e[<u") : NULL;
+	ok (p != NULL, "stop pops the flags");
+
+	termo_destroy (tk);
+	close (slave);
+	close (master);
+
+	return exit_status ();
+}
@@ -13,7 +13,7 @@ main (int argc, char *argv[])
 	size_t nargs = 16;
 	unsigned long command;
 
-	plan_tests (15);
+	plan_tests (48);
 
 	tk = termo_new_abstract ("vt100", NULL, 0);
 
@@ -50,6 +50,66 @@ main (int argc, char *argv[])
 		TERMO_RES_KEY, "interpret_csi yields RES_KEY");
 	is_int (command, ('$' << 16) | ('?' << 8) | 'x', "command for unknown CSI");
 
+	termo_push_bytes (tk, "\e[12", 4);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN for the first piece of CSI");
+	termo_push_bytes (tk, "3;;4", 4);
+	is_int (termo_getkey (tk, &key), TERMO_RES_AGAIN,
+		"getkey yields RES_AGAIN for the second piece of CSI");
+	termo_push_bytes (tk, "5v", 2);
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for CSI in pieces");
+
+	nargs = 16;
+	termo_interpret_csi (tk, &key, args, &nargs, &command);
+	is_int (nargs, 3, "nargs for CSI in pieces");
+	is_int (args[0], 123, "args[0] for CSI in pieces");
+	is_int (args[1], -1, "args[1] for CSI in pieces");
+	is_int (args[2], 45, "args[2] for CSI in pieces");
+
+	const termo_csi_info_t *info;
+	termo_push_bytes (tk, "\e[>4;38:2::255:0;;1 q", 21);
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_KEY,
+		"getkey yields RES_KEY for CSI > SP q");
+	is_int (key.type, TERMO_TYPE_UNKNOWN_CSI, "key.type for unknown CSI");
+	is_int (termo_get_buffer_remaining (tk), 256,
+		"buffer free 256 after unknown CSI");
+	is_int (termo_interpret_csi_info (tk, &key, &info), TERMO_RES_KEY,
+		"interpret_csi_info yields RES_KEY");
+
+	is_int (info->command, (' ' << 16) | ('>' << 8) | 'q',
+		"info->command for unknown CSI");
+	is_int (info->initial, '>', "info->initial for unknown CSI");
+	is_str (info->intermediates, " ", "info->intermediates for unknown CSI");
+	is_int (info->final, 'q', "info->final for unknown CSI");
+
+	is_int (info->nargs, 4, "info->nargs for unknown CSI");
+	is_int (info->args[0], 4, "info->args[0] for unknown CSI");
+	is_int (info->args[1], 38, "info->args[1] for unknown CSI");
+	is_int (info->args[2], -1, "info->args[2] for unknown CSI");
+	is_int (info->args[3], 1, "info->args[3] for unknown CSI");
+
+	is_int (info->nsubargs, 4, "info->nsubargs for unknown CSI");
+	is_int (info->subargi[1], 0, "info->subargi[1] for unknown CSI");
+	is_int (info->subargi[2], 4, "info->subargi[2] for unknown CSI");
+	is_int (info->subargi[4], 4, "info->subargi[4] for unknown CSI");
+	is_int (info->subargs[0], 2, "info->subargs[0] for unknown CSI");
+	is_int (info->subargs[1], -1, "info->subargs[1] for unknown CSI");
+	is_int (info->subargs[2], 255, "info->subargs[2] for unknown CSI");
+	is_int (info->subargs[3], 0, "info->subargs[3] for unknown CSI");
+
+	nargs = 16;
+	termo_interpret_csi (tk, &key, args, &nargs, &command);
+	is_int (nargs, 4, "nargs with sub-parameters");
+	is_int (args[1], 38, "args[1] with sub-parameters");
+
+	is_int (termo_getkey (tk, &key), TERMO_RES_NONE,
+		"getkey yields RES_NONE after unknown CSI");
+	key.type = TERMO_TYPE_UNKNOWN_CSI;
+	is_int (termo_interpret_csi_info (tk, &key, &info), TERMO_RES_NONE,
+		"interpret_csi_info yields RES_NONE after another getkey");
+
 	termo_destroy (tk);
 	return exit_status ();
 }
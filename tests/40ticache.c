@@ -0,0 +1,63 @@
+// We want mkdtemp() and setenv()
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../termo.h"
+#include "taplib.h"
+
+static int
+decodes_up (void)
+{
+	termo_t *tk = termo_new_abstract ("xterm", NULL, 0);
+	if (!tk)
+		return 0;
+
+	termo_key_t key;
+	termo_push_bytes (tk, "\eOA", 3);
+	int result = termo_getkey (tk, &key) == TERMO_RES_KEY
+		&& key.type == TERMO_TYPE_KEYSYM && key.code.sym == TERMO_SYM_UP;
+
+	termo_destroy (tk);
+	return result;
+}
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	char dir[] = "/tmp/termo-test-XXXXXX";
+	char subdir[sizeof dir + 16], path[sizeof dir + 32];
+	struct stat st;
+
+	plan_tests (6);
+
+	if (!mkdtemp (dir))
+		return 1;
+	setenv ("XDG_CACHE_HOME", dir, 1);
+	snprintf (subdir, sizeof subdir, "%s/termo", dir);
+	snprintf (path, sizeof path, "%s/xterm", subdir);
+
+	ok (decodes_up (), "keys decode when compiled from terminfo");
+	ok (!stat (path, &st) && st.st_size > 0, "cache file has been written");
+
+	off_t size = st.st_size;
+	ok (decodes_up (), "keys decode when loaded from the cache");
+
+	FILE *fp = fopen (path, "w");
+	fputs ("garbage", fp);
+	fclose (fp);
+
+	ok (decodes_up (), "keys decode when the cache is broken");
+	ok (!stat (path, &st), "cache file still exists");
+	is_int (st.st_size, size, "broken cache file has been rewritten");
+
+	unlink (path);
+	rmdir (subdir);
+	rmdir (dir);
+	return exit_status ();
+}
@@ -0,0 +1,151 @@
+// We want mkdtemp() and setenv()
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../termo.h"
+#include "taplib.h"
+
+// Indexes of string capabilities within compiled terminfo entries
+#define KEY_F5 71
+#define KEY_UP 87
+
+static void
+put16 (FILE *fp, int value)
+{
+	fputc (value & 0xff, fp);
+	fputc (value >> 8 & 0xff, fp);
+}
+
+// Writes out a compiled terminfo entry in the format described in term(5),
+// with 32-bit numbers if `wide', and with an extended section if `extended'
+static int
+write_entry (const char *dir, const char *term, int wide, int extended)
+{
+	char path[256];
+	snprintf (path, sizeof path, "%s/%c", dir, *term);
+	mkdir (path, 0755);
+	snprintf (path, sizeof path, "%s/%c/%s", dir, *term, term);
+
+	FILE *fp = fopen (path, "wb");
+	if (!fp)
+		return 0;
+
+	static const char strings[] = "\033Qa\0\033Qb";
+	size_t names_len = strlen (term) + 1;
+	put16 (fp, wide ? 01036 : 0432);
+	put16 (fp, names_len);
+	put16 (fp, 0);
+	put16 (fp, 1);
+	put16 (fp, KEY_UP + 1);
+	put16 (fp, sizeof strings);
+
+	fwrite (term, 1, names_len, fp);
+	if (names_len & 1)
+		fputc (0, fp);
+
+	// The number of columns
+	put16 (fp, 80);
+	if (wide)
+		put16 (fp, 0);
+
+	for (int i = 0; i <= KEY_UP; i++)
+		put16 (fp, i == KEY_UP ? 0 : i == KEY_F5 ? 4 : -1);
+	fwrite (strings, 1, sizeof strings, fp);
+
+	if (extended)
+	{
+		// One boolean and one string, followed by both of their names
+		static const char ext_strings[] = "\033[?1006;1000%?%p1%{1}%=%th%el%;";
+		static const char ext_names[] = "AX\0XM";
+
+		if (sizeof strings & 1)
+			fputc (0, fp);
+		put16 (fp, 1);
+		put16 (fp, 0);
+		put16 (fp, 1);
+		put16 (fp, 3);
+		put16 (fp, sizeof ext_strings + sizeof ext_names);
+
+		fputc (1, fp);
+		fputc (0, fp);
+
+		put16 (fp, 0);
+		put16 (fp, 0);
+		put16 (fp, 3);
+		fwrite (ext_strings, 1, sizeof ext_strings, fp);
+		fwrite (ext_names, 1, sizeof ext_names, fp);
+	}
+	return !fclose (fp);
+}
+
+static void
+check_entry (const char *term)
+{
+	char name[128];
+	termo_t *tk = termo_new_abstract (term, NULL, 0);
+	snprintf (name, sizeof name, "%s has been loaded", term);
+	ok (tk != NULL, name);
+	if (!tk)
+	{
+		fail ("Up decodes");
+		fail ("F5 decodes");
+		return;
+	}
+
+	termo_key_t key;
+	termo_push_bytes (tk, "\033Qa\033Qb", 6);
+
+	snprintf (name, sizeof name, "Up decodes for %s", term);
+	ok (termo_getkey (tk, &key) == TERMO_RES_KEY
+		&& key.type == TERMO_TYPE_KEYSYM && key.code.sym == TERMO_SYM_UP, name);
+	snprintf (name, sizeof name, "F5 decodes for %s", term);
+	ok (termo_getkey (tk, &key) == TERMO_RES_KEY
+		&& key.type == TERMO_TYPE_FUNCTION && key.code.number == 5, name);
+
+	termo_destroy (tk);
+}
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	static const char *terms[] =
+		{ "termo-legacy", "termo-wide", "termo-extended" };
+	char dir[] = "/tmp/termo-test-XXXXXX";
+	char path[sizeof dir + 32];
+
+	plan_tests (9);
+
+	if (!mkdtemp (dir))
+		return 1;
+	setenv ("TERMINFO", dir, 1);
+	setenv ("XDG_CACHE_HOME", dir, 1);
+
+	if (!write_entry (dir, terms[0], 0, 0)
+	 || !write_entry (dir, terms[1], 1, 0)
+	 || !write_entry (dir, terms[2], 1, 1))
+		return 1;
+
+	for (size_t i = 0; i < sizeof terms / sizeof *terms; i++)
+		check_entry (terms[i]);
+
+	for (size_t i = 0; i < sizeof terms / sizeof *terms; i++)
+	{
+		snprintf (path, sizeof path, "%s/t/%s", dir, terms[i]);
+		unlink (path);
+		snprintf (path, sizeof path, "%s/termo/%s", dir, terms[i]);
+		unlink (path);
+	}
+	snprintf (path, sizeof path, "%s/t", dir);
+	rmdir (path);
+	snprintf (path, sizeof path, "%s/termo", dir);
+	rmdir (path);
+	rmdir (dir);
+	return exit_status ();
+}
@@ -0,0 +1,106 @@
+// We want mkdtemp() and setenv()
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../termo.h"
+#include "taplib.h"
+
+#define THREADS 8
+#define ROUNDS 200
+
+// Both built-in terminals and ones that need to be loaded from terminfo
+static const char *terms[] =
+	{ "xterm-256color", "linux", "vt100", "xterm", "screen", "rxvt" };
+#define NTERMS (sizeof terms / sizeof *terms)
+
+static int available[NTERMS];
+
+static int
+decodes_keys (termo_t *tk)
+{
+	termo_key_t key;
+	termo_push_bytes (tk, "\e[Ax\e[1;5C", 10);
+
+	return termo_getkey (tk, &key) == TERMO_RES_KEY
+		&& key.type == TERMO_TYPE_KEYSYM && key.code.sym == TERMO_SYM_UP
+		&& termo_getkey (tk, &key) == TERMO_RES_KEY
+		&& key.type == TERMO_TYPE_KEY && key.code.codepoint == 'x'
+		&& termo_getkey (tk, &key) == TERMO_RES_KEY
+		&& key.type == TERMO_TYPE_KEYSYM && key.code.sym == TERMO_SYM_RIGHT
+		&& key.modifiers == TERMO_KEYMOD_CTRL;
+}
+
+// Creates and destroys instances for all terminals, in a different order
+// in each thread, so that they keep meeting over the same entries
+static void *
+worker (void *arg)
+{
+	size_t id = (size_t) arg;
+	size_t failures = 0;
+	for (size_t i = 0; i < ROUNDS; i++)
+	{
+		size_t which = (id + i) % NTERMS;
+		if (!available[which])
+			continue;
+
+		termo_t *tk = termo_new_abstract (terms[which], "UTF-8", 0);
+		if (!tk || !decodes_keys (tk))
+			failures++;
+		if (tk)
+			termo_destroy (tk);
+	}
+	return (void *) failures;
+}
+
+int
+main (int argc, char *argv[])
+{
+	(void) argc;
+	(void) argv;
+
+	char dir[] = "/tmp/termo-test-XXXXXX";
+	char path[sizeof dir + 32];
+	pthread_t threads[THREADS];
+	char name[64];
+
+	plan_tests (THREADS + 1);
+
+	// Keep the on-disk cache out of the way
+	if (!mkdtemp (dir))
+		return 1;
+	setenv ("XDG_CACHE_HOME", dir, 1);
+
+	// Not every terminal needs to be found, but those that are must work
+	for (size_t i = 0; i < NTERMS; i++)
+	{
+		termo_t *tk = termo_new_abstract (terms[i], "UTF-8", 0);
+		if ((available[i] = tk != NULL))
+			termo_destroy (tk);
+	}
+	ok (available[0], "a built-in terminal is available");
+
+	for (size_t i = 0; i < THREADS; i++)
+		if (pthread_create (&threads[i], NULL, worker, (void *) i))
+			return 1;
+
+	for (size_t i = 0; i < THREADS; i++)
+	{
+		void *failures = NULL;
+		pthread_join (threads[i], &failures);
+		snprintf (name, sizeof name, "thread %zu created working instances", i);
+		ok (failures == NULL, name);
+	}
+
+	for (size_t i = 0; i < NTERMS; i++)
+	{
+		snprintf (path, sizeof path, "%s/termo/%s", dir, terms[i]);
+		unlink (path);
+	}
+	snprintf (path, sizeof path, "%s/termo", dir);
+	rmdir (path);
+	rmdir (dir);
+	return exit_status ();
+}
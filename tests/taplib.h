@@ -5,3 +5,11 @@ void fail (char *name);
 void is_int (int got, int expect, char *name);
 void is_str (const char *got, const char *expect, char *name);
 int exit_status (void);
+
+#ifdef TEST_AUTOMATON
+// Runs the same tests through the unified decoding automaton
+#define termo_new(fd, encoding, flags) \
+	termo_new ((fd), (encoding), (flags) | TERMO_FLAG_AUTOMATON)
+#define termo_new_abstract(term, encoding, flags) \
+	termo_new_abstract ((term), (encoding), (flags) | TERMO_FLAG_AUTOMATON)
+#endif